@@ -87,7 +87,7 @@ int main(void)
     // Create Timer1
     // Provide the required arguments in the function call
     //50 ticks = 5 secs
-    timer_obj1 = RTOSTmrCreate(10, 50, RTOS_TMR_PERIODIC, function1, NULL, timer_name[0], &err_val);
+    timer_obj1 = RTOSTmrCreate(10, 50, RTOS_TMR_PERIODIC, RTOS_TMR_PRIO_NORMAL, function1, NULL, timer_name[0], &err_val);
     // Check the return value and determine if it created successfully or not
     if(err_val != RTOS_SUCCESS){
         printf("Timer1 Create Error: %d",err_val);
@@ -96,7 +96,7 @@ int main(void)
     // Create Timer2
     // Provide the required arguments in the function call
     //30 ticks = 3 secs
-    timer_obj2 = RTOSTmrCreate(10, 30, RTOS_TMR_PERIODIC, function2, NULL, timer_name[1], &err_val);
+    timer_obj2 = RTOSTmrCreate(10, 30, RTOS_TMR_PERIODIC, RTOS_TMR_PRIO_NORMAL, function2, NULL, timer_name[1], &err_val);
     // Check the return value and determine if it created successfully or not
     if(err_val != RTOS_SUCCESS){
         printf("Timer2 Create Error: %d",err_val);
@@ -105,7 +105,7 @@ int main(void)
     // Create Timer3
     // Provide the required arguments in the function call
     //100 ticks = 10 secs
-    timer_obj3 = RTOSTmrCreate(100, 0, RTOS_TMR_ONE_SHOT, function3, NULL, timer_name[2], &err_val);
+    timer_obj3 = RTOSTmrCreate(100, 0, RTOS_TMR_ONE_SHOT, RTOS_TMR_PRIO_NORMAL, function3, NULL, timer_name[2], &err_val);
     // Check the return value and determine if it created successfully or not
     if(err_val != RTOS_SUCCESS){
         printf("Timer3 Create Error: %d",err_val);
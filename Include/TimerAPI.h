@@ -5,12 +5,22 @@
 
 #include "TimerMgrHeader.h"
 #include "TypeDefines.h"
+#include <time.h>
+#include <pthread.h>
 
 // TIMER MANAGER APIs
 
 extern void RTOSTmrInit(void);
 
-extern RTOS_TMR* RTOSTmrCreate(INT32U delay, INT32U period, INT8U option, RTOS_TMR_CALLBACK callback, void *callback_arg, INT8	*name, INT8U *err);
+extern RTOS_TMR* RTOSTmrCreate(INT32U delay, INT32U period, INT8U option, INT8U prio, RTOS_TMR_CALLBACK callback, void *callback_arg, INT8	*name, INT8U *err);
+
+#if RTOS_CFG_TMR_INLINE_ARG_SIZE > 0
+extern RTOS_TMR* RTOSTmrCreateInline(INT32U delay, INT32U period, INT8U option, INT8U prio, RTOS_TMR_CALLBACK callback, const void *arg_data, INT32U arg_size, INT8 *name, INT8U *err);
+#endif
+
+extern RTOS_TMR* RTOSTmrCreateAbs(const struct timespec *deadline, INT32U period, INT8U option, INT8U prio, RTOS_TMR_CALLBACK callback, void *callback_arg, INT8 *name, INT8U *err);
+
+extern INT8U RTOSTmrPolicySet(RTOS_TMR *ptmr, INT8U policy, INT8U *perr);
 
 extern INT8U RTOSTmrDel(RTOS_TMR *ptmr, INT8U *perr);
 
@@ -24,10 +34,48 @@ extern INT8U RTOSTmrStart(RTOS_TMR *ptmr, INT8U *perr);
 
 extern INT8U RTOSTmrStop(RTOS_TMR *ptmr, INT8U opt, void *callback_arg, INT8U *perr);
 
+extern INT32U RTOSTmrSnapshot(RTOS_TMR_INFO *info, INT32U max_count, INT8U *perr);
+
+extern void RTOSTmrBudgetSet(INT32U max_count, INT32U max_ns);
+
+extern void RTOSTmrStatsGet(RTOS_TMR_STATS *stats);
+
 extern void RTOSTmrSignal(int signum);
 
 extern void OSTickInitialize(void);
 
+extern INT8U OSTickInitializeCfg(const RTOS_TICK_CFG *cfg, INT8U *perr);
+
+extern void OSTickSignal(INT32U expirations);
+
+extern void OSTickStatsGet(RTOS_TICK_STATS *stats);
+
+extern int OSTickThreadCreate(pthread_t *thread, void *(*task)(void *));
+
+// OS Tick Sources
+extern const RTOS_TICK_SOURCE RTOSTickSrcSigalrm;
+
+extern const RTOS_TICK_SOURCE RTOSTickSrcTimerfd;
+
+// SHARED MEMORY TIMER SERVICE APIs
+
+extern INT8U RTOSTmrShmServiceStart(const char *name, INT8U *perr);
+
+extern RTOS_SHM_CLIENT* RTOSTmrShmAttach(const char *name, INT8U *perr);
+
+extern INT8U RTOSTmrShmDetach(RTOS_SHM_CLIENT *pclient, INT8U *perr);
+
+extern INT16U RTOSTmrShmArm(RTOS_SHM_CLIENT *pclient, INT32U delay, INT32U period, INT8U option, INT8U prio, INT32U cookie, INT8U *perr);
+
+extern INT8U RTOSTmrShmCancel(RTOS_SHM_CLIENT *pclient, INT16U slot, INT8U *perr);
+
+extern INT8U RTOSTmrShmPoll(RTOS_SHM_CLIENT *pclient, INT8U wait, INT16U *pslot, INT32U *pcookie, INT8U *perr);
+
+extern INT32U RTOSTmrShmDroppedGet(RTOS_SHM_CLIENT *pclient);
+
+// Called by the Timer Task at the start of every pass, before the Ticks are processed
+extern void (*RTOSTmrTickHook)(void);
+
 // Internal Functions
 INT8U Create_Timer_Pool(INT32U timer_count);
 
@@ -39,8 +87,18 @@ void remove_hash_entry(RTOS_TMR *timer_obj);
 
 void* RTOSTmrTask(void* temp);
 
+void* RTOSTmrPrioTask(void* temp);
+
+INT32U get_monotonic_tick(void);
+
+INT32U timespec_to_tick(const struct timespec *ts);
+
+RTOS_TMR* create_tick_timer(INT32U match, INT32U period, INT8U option, INT8U prio, RTOS_TMR_CALLBACK callback, void *callback_arg, INT8 *name, INT8U *err);
+
 RTOS_TMR* alloc_timer_obj(void);
 
+void shm_service_poll(void);
+
 void free_timer_obj(RTOS_TMR *ptmr);
 
 #endif
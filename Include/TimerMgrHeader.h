@@ -4,10 +4,19 @@
 #define TIMER_MGR_HEADER
 
 #include "TypeDefines.h"
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
 
-// OS Tick Time in ns
+// OS Tick Time in ns, default of OSTickInitialize()
 #define RTOS_CFG_TMR_TASK_RATE	100000000
 
+// Fastest OS Tick accepted by OSTickInitializeCfg() in ns
+#define RTOS_CFG_TMR_MIN_TASK_RATE	100000
+
+// Longest delay, period or deadline in Ticks, Ticks are compared as signed 32 bit differences
+#define RTOS_TMR_MAX_TICKS	0x7FFFFFFF
+
 // Lets assume RTOS Timer Type = 20
 #define RTOS_TMR_TYPE	20
 
@@ -25,6 +34,26 @@
 #define RTOS_TMR_ONE_SHOT	1
 #define RTOS_TMR_PERIODIC	2
 
+// Bytes of Callback Argument stored inside each Timer by RTOSTmrCreateInline() (0 = Disabled)
+#define RTOS_CFG_TMR_INLINE_ARG_SIZE	48
+
+// RTOS Timer Priority Classes, Timers Expiring on the same Tick are dispatched highest priority first
+#define RTOS_TMR_PRIO_HIGH	0
+#define RTOS_TMR_PRIO_NORMAL	1
+#define RTOS_TMR_PRIO_LOW	2
+#define RTOS_TMR_PRIO_CLASSES	3
+
+// Dispatch RTOS_TMR_PRIO_HIGH Timers from a dedicated thread instead of the Timer Task (0 = Disabled)
+// Their Callbacks then run concurrently with the other Callbacks and are not limited by the Tick Budget
+#define RTOS_CFG_TMR_PRIO_THREAD	0
+
+// RTOS Periodic Timer Policies (when the next period deadline has already passed)
+#define RTOS_TMR_PERIOD_CATCHUP	1	/* Fire once for every missed period */
+#define RTOS_TMR_PERIOD_SKIP	2	/* Drop the missed periods and keep the original phase */
+
+// Default Policy for Periodic Timers
+#define RTOS_CFG_TMR_PERIOD_POLICY	RTOS_TMR_PERIOD_SKIP
+
 
 // Error Code
 #define RTOS_ERR_NONE			        0
@@ -42,14 +71,58 @@
 #define RTOS_ERR_TMR_NO_CALLBACK	    11
 #define RTOS_ERR_MUTEX_INIT_FAILED      12
 #define RTOS_ERR_TSK_SEM_INIT_FAILED    13
+#define RTOS_ERR_TMR_INVALID_POLICY     14
+#define RTOS_ERR_TMR_INVALID_PRIO       15
+#define RTOS_ERR_SHM_OPEN_FAILED        16
+#define RTOS_ERR_SHM_NO_CLIENT          17
+#define RTOS_ERR_SHM_RING_FULL          18
+#define RTOS_ERR_SHM_NO_SLOT            19
+#define RTOS_ERR_SHM_NO_EVENT           20
+#define RTOS_ERR_SNAPSHOT_TRUNCATED     21
+#define RTOS_ERR_TICK_INVALID_RATE      22
+#define RTOS_ERR_TICK_INIT_FAILED       23
+#define RTOS_ERR_TMR_ARG_TOO_BIG        24
+#define RTOS_ERR_TICK_ALREADY_INIT      25
 
 // RTOS Stop Options
 #define RTOS_TMR_OPT_NONE		1
 #define RTOS_TMR_OPT_CALLBACK		2
 #define RTOS_TMR_OPT_CALLBACK_ARG	3
 
+// Initial and minimum number of Hash Table buckets
 #define HASH_TABLE_SIZE		10
 
+// Adaptive Hash Table, the bucket count follows the number of armed Timers
+#define RTOS_CFG_HASH_MAX_SIZE		1048576	/* Maximum number of buckets */
+#define RTOS_CFG_HASH_GROW_LOAD		4	/* Double the buckets above this many armed Timers per bucket */
+#define RTOS_CFG_HASH_SHRINK_LOAD	1	/* Halve the buckets below this many armed Timers per bucket */
+#define RTOS_CFG_HASH_REHASH_TICKS	64	/* A resize moves 1/RTOS_CFG_HASH_REHASH_TICKS of the buckets per Timer Task pass */
+
+// Per Tick Callback Budget of the Timer Task (0 = Unlimited)
+// Expired Timers beyond the budget wait in the Overflow Queue for the next Ticks, in deadline order
+#define RTOS_CFG_TMR_TICK_BUDGET_CNT	0	/* Max Callbacks per Timer Task pass */
+#define RTOS_CFG_TMR_TICK_BUDGET_NS	0	/* Max time spent in Callbacks per Timer Task pass in ns */
+
+// Shared Memory Timer Service
+#define RTOS_SHM_MAGIC	0x544D5253	/* Marks an initialized Shared Memory Segment */
+#define RTOS_CFG_SHM_MAX_CLIENTS	64	/* Client Processes per Timer Service */
+#define RTOS_CFG_SHM_RING_SIZE	1024	/* Messages per Ring, must be a power of 2 */
+#define RTOS_CFG_SHM_TMRS_PER_CLIENT	256	/* Timers each Client can have armed */
+#define RTOS_CFG_SHM_MODE	0600	/* Permissions of the Segment, anyone who can write it can Arm and Cancel Timers */
+#define RTOS_CFG_SHM_REAP_TICKS	1000	/* Ticks between checks for Clients which exited without detaching */
+
+// Shared Memory Ring Messages
+#define RTOS_SHM_OP_ARM		1	/* Client -> Service: Arm a Timer in a Slot */
+#define RTOS_SHM_OP_CANCEL	2	/* Client -> Service: Cancel the Timer in a Slot */
+#define RTOS_SHM_OP_DETACH	3	/* Client -> Service: Cancel all the Timers and free the Client */
+#define RTOS_SHM_OP_EXPIRED	4	/* Service -> Client: The Timer in a Slot Expired */
+#define RTOS_SHM_OP_FAILED	5	/* Service -> Client: The Timer in a Slot could not be Armed */
+
+// Shared Memory Client States
+#define RTOS_SHM_CLIENT_FREE		0
+#define RTOS_SHM_CLIENT_CLAIMED	1
+#define RTOS_SHM_CLIENT_ATTACHED	2
+
 // Timer Callback
 typedef void (*RTOS_TMR_CALLBACK)(void *p_arg);
 
@@ -61,10 +134,21 @@ typedef struct os_timer {
 
     void	*RTOSTmrCallbackArg;	        /* Callback Function Arguments */
 
+#if RTOS_CFG_TMR_INLINE_ARG_SIZE > 0
+    union {
+        INT8U	bytes[RTOS_CFG_TMR_INLINE_ARG_SIZE];
+        INT64U	align_int;
+        double	align_double;
+        void	*align_ptr;
+    } RTOSTmrInlineArg;	                    /* Callback Argument copied in by RTOSTmrCreateInline(), no heap allocation */
+#endif
+
     struct os_timer	*RTOSTmrNext;	        /* Double Link List Pointers */
     struct os_timer	*RTOSTmrPrev;
 
-    INT32U	RTOSTmrMatch;	                /* Timer Expires when RTOSTmrTickCtr = RTOSTmrMatch */
+    struct hash_obj	*RTOSTmrBucket;	        /* Hash Table bucket holding the Timer, NULL if none */
+
+    INT32U	RTOSTmrMatch;	                /* Timer Expires when RTOSTmrTickCtr = RTOSTmrMatch, Periodic Timers advance it by RTOSTmrPeriod */
 
     INT32U	RTOSTmrDelay;	                /* One Shot Timer - Time for one shot, Periodic Timer - Delay before periodic update starts */
 
@@ -74,6 +158,18 @@ typedef struct os_timer {
 
     INT8U	RTOSTmrOpt;	                    /* Timer Options */
 
+    INT8U	RTOSTmrPrio;	                /* Priority Class, RTOS_TMR_PRIO_HIGH to RTOS_TMR_PRIO_LOW */
+
+    INT8U	RTOSTmrPolicy;	                /* Periodic Policy - RTOS_TMR_PERIOD_CATCHUP or RTOS_TMR_PERIOD_SKIP */
+
+    INT8U	RTOSTmrAbs;	                    /* RTOS_TRUE if RTOSTmrMatch holds an Absolute Deadline not yet armed */
+
+    INT8U	RTOSTmrDeferred;	            /* RTOS_TRUE while Expired and waiting in the Overflow Queue */
+
+    INT8U	RTOSTmrLate;	                /* RTOS_TRUE once the queued Expiry is counted in deferred_count */
+
+    volatile INT32U	RTOSTmrSeq;	            /* Sequence Lock for RTOSTmrSnapshot(), odd while the Timer is being updated */
+
     INT8U	RTOSTmrState;	                /* State of the Timer
                                            RTOS_TMR_STATE_UNUSED
                                            RTOS_TMR_STATE_STOPPED
@@ -83,9 +179,131 @@ typedef struct os_timer {
 
 // Hash Table Entry Structure
 typedef struct hash_obj {
-    INT8U	timer_count;
+    INT32U	timer_count;
     RTOS_TMR *list_ptr;
 } HASH_OBJ;
 
+// Timer Snapshot Entry, filled by RTOSTmrSnapshot()
+typedef struct tmr_info {
+    RTOS_TMR	*ptmr;
+    INT8	*name;
+    INT8U	state;
+    INT8U	option;
+    INT8U	prio;
+    INT32U	remain;	            /* Ticks until the next Expiry, 0 unless Running */
+    INT32U	period;
+} RTOS_TMR_INFO;
+
+// Overflow Queue Structure, Expired Timers of one Priority Class in deadline order
+typedef struct overflow_obj {
+    INT32U	timer_count;
+    RTOS_TMR *list_ptr;
+    RTOS_TMR *tail_ptr;
+} OVERFLOW_OBJ;
+
+// Shared Memory Ring Message
+typedef struct shm_msg {
+    INT8U	op;	        /* RTOS_SHM_OP_xxx */
+    INT8U	option;	    /* RTOS_TMR_ONE_SHOT or RTOS_TMR_PERIODIC */
+    INT8U	prio;	    /* Priority Class */
+    INT8U	status;	    /* RTOS_ERR_xxx the Timer could not be Armed with, for RTOS_SHM_OP_FAILED */
+    INT16U	slot;	    /* Client Timer Slot */
+    INT16U	gen;	    /* Slot Generation, tells a stale Expiry from the current Timer */
+    INT32U	match;	    /* Absolute Tick of the first Expiry */
+    INT32U	period;
+    INT32U	cookie;	    /* Opaque Client value, returned on Expiry */
+} SHM_MSG;
+
+// Single Producer Single Consumer Ring, head and tail on their own cache lines
+typedef struct shm_ring {
+    volatile INT32U	head;	    /* Next Message to write, owned by the Producer */
+    INT8U	pad_head[60];
+    volatile INT32U	tail;	    /* Next Message to read, owned by the Consumer */
+    INT8U	pad_tail[60];
+    SHM_MSG	msgs[RTOS_CFG_SHM_RING_SIZE];
+} SHM_RING;
+
+// Per Client area of the Shared Memory Segment
+typedef struct shm_client {
+    volatile INT32U	state;	        /* RTOS_SHM_CLIENT_xxx */
+    INT32U	pid;	                /* Client Process, its Timers are Cancelled once it is gone */
+    INT32U	notify_dropped;	        /* Periodic Expiries lost because the Notification Ring was full */
+    sem_t	notify_sem;	            /* Process Shared, posted for every Notification */
+    SHM_RING	req_ring;	        /* Client -> Service */
+    SHM_RING	notify_ring;	    /* Service -> Client */
+} SHM_CLIENT;
+
+// Shared Memory Segment owned by the Timer Service
+typedef struct shm_segment {
+    INT32U	magic;
+    INT32U	tick_rate;	            /* ns per Tick */
+    struct timespec	tick_epoch;	    /* CLOCK_MONOTONIC time of Tick 0, Clients derive the Tick from it */
+    SHM_CLIENT	clients[RTOS_CFG_SHM_MAX_CLIENTS];
+} SHM_SEGMENT;
+
+// Service side Timer of a Client Slot, passed as the Callback Argument
+typedef struct shm_tmr_ctx {
+    RTOS_TMR	*ptmr;	        /* NULL when the Slot has no Timer in the Service */
+    INT16U	client;
+    INT16U	slot;
+    INT16U	gen;
+    INT8U	option;
+    INT32U	cookie;
+    INT8U	notify_pending;	/* RTOS_TRUE while notify_msg waits for room in the Notification Ring */
+    SHM_MSG	notify_msg;	    /* Last Notification of the Slot, never dropped */
+} SHM_TMR_CTX;
+
+// Process local handle of a Shared Memory Client
+typedef struct shm_client_handle {
+    SHM_SEGMENT	*segment;
+    SHM_CLIENT	*client;
+    pthread_mutex_t	lock;	/* Serializes the threads of the Client, the Rings have a single Producer and Consumer */
+    INT16U	free_count;
+    INT16U	free_slots[RTOS_CFG_SHM_TMRS_PER_CLIENT];	/* Stack of unused Slots */
+    INT16U	slot_gen[RTOS_CFG_SHM_TMRS_PER_CLIENT];
+    INT8U	slot_armed[RTOS_CFG_SHM_TMRS_PER_CLIENT];
+} RTOS_SHM_CLIENT;
+
+// OS Tick Configuration, see OSTickInitializeCfg()
+struct tick_source;
+typedef struct tick_cfg {
+    const struct tick_source	*source;	/* RTOSTickSrcSigalrm, RTOSTickSrcTimerfd or an application Tick Source */
+    INT32U	rate_ns;	                    /* OS Tick Time, RTOS_CFG_TMR_MIN_TASK_RATE or more */
+    INT32	fifo_prio;	                    /* SCHED_FIFO priority of the Tick and Timer Task threads, 0 = normal scheduling */
+    INT32	cpu;	                        /* CPU the Tick and Timer Task threads are pinned to, -1 = any */
+} RTOS_TICK_CFG;
+
+// OS Tick Source, start() must call OSTickSignal() once per Tick from then on
+typedef struct tick_source {
+    const char	*name;
+    INT8U	(*start)(const RTOS_TICK_CFG *cfg, INT8U *perr);
+} RTOS_TICK_SOURCE;
+
+// OS Tick Statistics, lateness of each Tick against its ideal CLOCK_MONOTONIC time
+typedef struct tick_stats {
+    INT64U	ticks;	                /* Tick Source wakeups */
+    INT64U	missed;	                /* Ticks merged into a later wakeup */
+    INT64U	jitter_min_ns;
+    INT64U	jitter_max_ns;
+    INT64U	jitter_sum_ns;	        /* jitter_sum_ns / ticks is the average */
+} RTOS_TICK_STATS;
+
+// Timer Task Statistics
+typedef struct tmr_stats {
+    INT32U	deferred_count;	        /* Expirations left queued at the end of a pass, each counted once */
+    INT32U	budget_exhausted;	    /* Timer Task passes which stopped on the budget */
+    INT32U	overflow_depth;	        /* Expired Timers waiting in the Overflow Queue */
+    INT32U	overflow_peak;	        /* Highest overflow_depth seen */
+    INT32U	max_pass_ns;	        /* Longest Timer Task pass in ns */
+    INT32U	bucket_count;	        /* Current Hash Table size */
+    INT32U	armed_count;	        /* Timers in the Hash Table */
+    INT32U	resizes;	            /* Hash Table grows and shrinks started */
+    INT64U	ticks_collected;
+    INT64U	nodes_scanned;	        /* nodes_scanned / ticks_collected is the average scan per Tick */
+    INT64U	collect_passes;	        /* Timer Task passes which collected Ticks */
+    INT64U	collect_late_max_ns;	/* Lateness of the oldest Tick collected in a pass */
+    INT64U	collect_late_sum_ns;	/* collect_late_sum_ns / collect_passes is the average */
+} RTOS_TMR_STATS;
+
 #endif
 
@@ -4,6 +4,8 @@
 #include "Include/TimerAPI.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <pthread.h>
 #include <semaphore.h>
 #include <signal.h>
@@ -14,18 +16,61 @@
  *****************************************************
  */
 // Timer Pool Global Variables
-INT8U FreeTmrCount = 0;
+INT32U FreeTmrCount = 0;
 RTOS_TMR *FreeTmrListPtr = NULL;
 
+// Timer Pool Array, walked without locks by RTOSTmrSnapshot()
+RTOS_TMR *TmrPool = NULL;
+INT32U TmrPoolSize = 0;
+
 // Tick Counter
 INT32U RTOSTmrTickCtr = 0;
 
-// Hash Table
-HASH_OBJ hash_table[HASH_TABLE_SIZE];
+// Monotonic Time of Tick 0, all Ticks are derived from CLOCK_MONOTONIC relative to it
+struct timespec RTOSTmrTickEpoch;
+
+// OS Tick Time in ns, set by OSTickInitializeCfg()
+INT32U RTOSTmrTickRate = RTOS_CFG_TMR_TASK_RATE;
+
+// Hash Table, only the Timer Task resizes it
+HASH_OBJ *hash_table = NULL;
+INT32U hash_size = 0;
+// Changed under hash_table_mutex but updated atomically, the Timer Task reads it without the lock
+INT32U hash_timer_count = 0;
+
+// Hash Table being migrated into hash_table, buckets below rehash_pos are already moved
+HASH_OBJ *old_hash_table = NULL;
+INT32U old_hash_size = 0;
+INT32U rehash_pos = 0;
+
+// Expired Timers left over by the Per Tick Callback Budget, one queue per Priority Class, protected by hash_table_mutex
+OVERFLOW_OBJ overflow_queue[RTOS_TMR_PRIO_CLASSES];
+INT32U overflow_count = 0;
+
+// Per Tick Callback Budget (0 = Unlimited)
+INT32U RTOSTmrBudgetCnt = RTOS_CFG_TMR_TICK_BUDGET_CNT;
+INT32U RTOSTmrBudgetNs = RTOS_CFG_TMR_TICK_BUDGET_NS;
+
+// Timer Task Statistics, protected by hash_table_mutex
+RTOS_TMR_STATS RTOSTmrStats;
+
+// Optional work done by the Timer Task on every pass, e.g. the Shared Memory Timer Service
+void (*RTOSTmrTickHook)(void) = NULL;
 
 // Thread variable for Timer Task
 pthread_t thread;
 
+#if RTOS_CFG_TMR_PRIO_THREAD
+// Thread variable and Semaphore for the High Priority Dispatch Task
+pthread_t prio_thread;
+sem_t prio_task_sem;
+
+// The Timer Task leaves RTOS_TMR_PRIO_HIGH to the High Priority Dispatch Task
+#define TASK_FIRST_PRIO	(RTOS_TMR_PRIO_HIGH + 1)
+#else
+#define TASK_FIRST_PRIO	RTOS_TMR_PRIO_HIGH
+#endif
+
 // Semaphore for Signaling the Timer Task
 sem_t timer_task_sem;
 
@@ -35,24 +80,43 @@ pthread_mutex_t hash_table_mutex;
 // Mutex for Protecting Timer Pool
 pthread_mutex_t timer_pool_mutex;
 
+// Start updating the Timer fields read by RTOSTmrSnapshot(), the Sequence becomes odd
+// The Sequence Lock has a single writer at a time, hash_table_mutex must be held around every update
+static inline void tmr_write_begin(RTOS_TMR *ptmr)
+{
+    __atomic_fetch_add(&ptmr->RTOSTmrSeq, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+// Done updating the Timer fields, the Sequence becomes even again
+static inline void tmr_write_end(RTOS_TMR *ptmr)
+{
+    __atomic_fetch_add(&ptmr->RTOSTmrSeq, 1, __ATOMIC_RELEASE);
+}
+
+// Hash Table helpers used by the APIs, hash_table_mutex must be held
+static void unlink_hash_entry(RTOS_TMR *timer_obj);
+static void arm_hash_entry(RTOS_TMR *timer_obj);
+static INT32U current_tick(void);
+
 /*****************************************************
  * Timer API Functions
  *****************************************************
  */
 
 // Function to create a Timer
-RTOS_TMR* RTOSTmrCreate(INT32U delay, INT32U period, INT8U option,
+RTOS_TMR* RTOSTmrCreate(INT32U delay, INT32U period, INT8U option, INT8U prio,
                         RTOS_TMR_CALLBACK callback, void *callback_arg, INT8 *name, INT8U *err)
 {
     RTOS_TMR *timer_obj = NULL;
     *err = RTOS_ERR_NONE;
     // Check the input Arguments for ERROR
-    if(delay < 1){
+    if(delay < 1 || delay > RTOS_TMR_MAX_TICKS){
         //cant be zero as it wont go to stopped state
         *err = RTOS_ERR_TMR_INVALID_DLY;
         return NULL;
     }
-    if(option == RTOS_TMR_PERIODIC && period < 1){
+    if(option == RTOS_TMR_PERIODIC && (period < 1 || period > RTOS_TMR_MAX_TICKS)){
         *err = RTOS_ERR_TMR_INVALID_PERIOD;
         return NULL;
     }
@@ -60,6 +124,10 @@ RTOS_TMR* RTOSTmrCreate(INT32U delay, INT32U period, INT8U option,
         *err = RTOS_ERR_TMR_INVALID_OPT;
         return NULL;
     }
+    if(prio >= RTOS_TMR_PRIO_CLASSES){
+        *err = RTOS_ERR_TMR_INVALID_PRIO;
+        return NULL;
+    }
 
     // Allocate a New Timer Obj
     timer_obj = alloc_timer_obj();
@@ -72,22 +140,144 @@ RTOS_TMR* RTOSTmrCreate(INT32U delay, INT32U period, INT8U option,
 
 
     // Fill up the Timer Object
+    pthread_mutex_lock(&hash_table_mutex);
+    tmr_write_begin(timer_obj);
     timer_obj->RTOSTmrType = RTOS_TMR_TYPE;
     timer_obj->RTOSTmrCallback = callback;
     timer_obj->RTOSTmrCallbackArg = callback_arg;
     timer_obj->RTOSTmrNext = NULL;
     timer_obj->RTOSTmrPrev = NULL;
+    timer_obj->RTOSTmrBucket = NULL;
     timer_obj->RTOSTmrMatch = 0;
     timer_obj->RTOSTmrDelay = delay;
     timer_obj->RTOSTmrPeriod = period;
     timer_obj->RTOSTmrName = name;
     timer_obj->RTOSTmrOpt = option;
+    timer_obj->RTOSTmrPrio = prio;
+    timer_obj->RTOSTmrPolicy = RTOS_CFG_TMR_PERIOD_POLICY;
+    timer_obj->RTOSTmrAbs = RTOS_FALSE;
+    timer_obj->RTOSTmrDeferred = RTOS_FALSE;
+    timer_obj->RTOSTmrLate = RTOS_FALSE;
     timer_obj->RTOSTmrState = RTOS_TMR_STATE_STOPPED;
+    tmr_write_end(timer_obj);
+    pthread_mutex_unlock(&hash_table_mutex);
 
     *err = RTOS_SUCCESS;
     return timer_obj;
 }
 
+#if RTOS_CFG_TMR_INLINE_ARG_SIZE > 0
+// Function to create a Timer whose Callback Argument is a copy of arg_data kept inside the Timer
+// The Callback gets a pointer to the copy, valid until the Timer is Deleted, so nothing has to be allocated or freed
+RTOS_TMR* RTOSTmrCreateInline(INT32U delay, INT32U period, INT8U option, INT8U prio,
+                              RTOS_TMR_CALLBACK callback, const void *arg_data, INT32U arg_size, INT8 *name, INT8U *err)
+{
+    RTOS_TMR *timer_obj = NULL;
+
+    // Check the input Arguments for ERROR
+    if(arg_size > RTOS_CFG_TMR_INLINE_ARG_SIZE){
+        *err = RTOS_ERR_TMR_ARG_TOO_BIG;
+        return NULL;
+    }
+    if(arg_data == NULL && arg_size != 0){
+        *err = RTOS_ERR_TMR_INVALID;
+        return NULL;
+    }
+
+    timer_obj = RTOSTmrCreate(delay, period, option, prio, callback, NULL, name, err);
+    if(timer_obj == NULL)
+        return NULL;
+
+    // Copy the Argument in the Timer Object, the bytes past arg_size are zero and not left from a previous Timer
+    memset(timer_obj->RTOSTmrInlineArg.bytes, 0, sizeof(timer_obj->RTOSTmrInlineArg.bytes));
+    if(arg_size != 0)
+        memcpy(timer_obj->RTOSTmrInlineArg.bytes, arg_data, arg_size);
+    timer_obj->RTOSTmrCallbackArg = timer_obj->RTOSTmrInlineArg.bytes;
+    return timer_obj;
+}
+#endif
+
+// Function to create a Timer which first Expires at an Absolute CLOCK_MONOTONIC Deadline
+RTOS_TMR* RTOSTmrCreateAbs(const struct timespec *deadline, INT32U period, INT8U option, INT8U prio,
+                           RTOS_TMR_CALLBACK callback, void *callback_arg, INT8 *name, INT8U *err)
+{
+    struct timespec now;
+    long long ahead_ns;
+
+    // Check the input Arguments for ERROR
+    if(deadline == NULL || deadline->tv_nsec < 0 || deadline->tv_nsec >= 1000000000){
+        *err = RTOS_ERR_TMR_INVALID_DLY;
+        return NULL;
+    }
+    // A Deadline RTOS_TMR_MAX_TICKS or more ahead would look like one in the past, seconds are checked first so the ns can't overflow
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(deadline->tv_sec - now.tv_sec > (time_t)((INT64U)RTOS_TMR_MAX_TICKS * RTOSTmrTickRate / 1000000000ULL)){
+        *err = RTOS_ERR_TMR_INVALID_DLY;
+        return NULL;
+    }
+    ahead_ns = (long long)(deadline->tv_sec - now.tv_sec) * 1000000000LL + (deadline->tv_nsec - now.tv_nsec);
+    if(ahead_ns > 0 && ahead_ns / RTOSTmrTickRate >= RTOS_TMR_MAX_TICKS){
+        *err = RTOS_ERR_TMR_INVALID_DLY;
+        return NULL;
+    }
+
+    return create_tick_timer(timespec_to_tick(deadline), period, option, prio, callback, callback_arg, name, err);
+}
+
+// Create a Timer whose first Expiry is on the absolute Tick match, used by RTOSTmrCreateAbs() and the Shared Memory Service
+// Callers keep match less than RTOS_TMR_MAX_TICKS ahead, anything further reads as a Tick in the past
+RTOS_TMR* create_tick_timer(INT32U match, INT32U period, INT8U option, INT8U prio,
+                            RTOS_TMR_CALLBACK callback, void *callback_arg, INT8 *name, INT8U *err)
+{
+    RTOS_TMR *timer_obj = NULL;
+    INT32U now_tick;
+    INT32U delay;
+
+    // RTOSTmrDelay is only used if the Timer is restarted, a Deadline already in the past gets the shortest one
+    pthread_mutex_lock(&hash_table_mutex);
+    now_tick = current_tick();
+    pthread_mutex_unlock(&hash_table_mutex);
+    delay = ((INT32)(match - now_tick) > 0) ? match - now_tick : 1;
+
+    timer_obj = RTOSTmrCreate(delay, period, option, prio, callback, callback_arg, name, err);
+    if(timer_obj == NULL)
+        return NULL;
+
+    // RTOSTmrStart() will arm the Timer on this Tick instead of RTOSTmrTickCtr + RTOSTmrDelay
+    pthread_mutex_lock(&hash_table_mutex);
+    tmr_write_begin(timer_obj);
+    timer_obj->RTOSTmrMatch = match;
+    timer_obj->RTOSTmrAbs = RTOS_TRUE;
+    tmr_write_end(timer_obj);
+    pthread_mutex_unlock(&hash_table_mutex);
+    return timer_obj;
+}
+
+// Function to select what a Periodic Timer does with the periods it has missed
+INT8U RTOSTmrPolicySet(RTOS_TMR *ptmr, INT8U policy, INT8U *perr)
+{
+    // ERROR Checking
+    if(ptmr == NULL){
+        *perr = RTOS_ERR_TMR_INVALID;
+        return RTOS_FALSE;
+    }
+    if(ptmr->RTOSTmrType != RTOS_TMR_TYPE){
+        *perr = RTOS_ERR_TMR_INVALID_TYPE;
+        return RTOS_FALSE;
+    }
+    if(ptmr->RTOSTmrState == RTOS_TMR_STATE_UNUSED){
+        *perr = RTOS_ERR_TMR_INACTIVE;
+        return RTOS_FALSE;
+    }
+    if(policy != RTOS_TMR_PERIOD_CATCHUP && policy != RTOS_TMR_PERIOD_SKIP){
+        *perr = RTOS_ERR_TMR_INVALID_POLICY;
+        return RTOS_FALSE;
+    }
+    ptmr->RTOSTmrPolicy = policy;
+    *perr = RTOS_ERR_NONE;
+    return RTOS_TRUE;
+}
+
 // Function to Delete a Timer
 INT8U RTOSTmrDel(RTOS_TMR *ptmr, INT8U *perr)
 {
@@ -165,7 +355,9 @@ INT32U RTOSTmrRemainGet(RTOS_TMR *ptmr, INT8U *perr)
         return RTOS_FALSE;
     }
     *perr = RTOS_ERR_NONE;
-    // Return the remaining ticks
+    // Return the remaining ticks, an Expired Timer waiting in the Overflow Queue has none
+    if((INT32)(ptmr->RTOSTmrMatch - RTOSTmrTickCtr) <= 0)
+        return 0;
     return ((ptmr->RTOSTmrMatch) - RTOSTmrTickCtr);
 }
 
@@ -197,6 +389,8 @@ INT8U RTOSTmrStateGet(RTOS_TMR *ptmr, INT8U *perr)
 // Function to start a Timer
 INT8U RTOSTmrStart(RTOS_TMR *ptmr, INT8U *perr)
 {
+    INT32U now_tick;
+
     // ERROR Checking
     *perr = RTOS_ERR_NONE;
     if(ptmr == NULL){
@@ -216,29 +410,42 @@ INT8U RTOSTmrStart(RTOS_TMR *ptmr, INT8U *perr)
         *perr = RTOS_ERR_TMR_INVALID_STATE;
         return RTOS_FALSE;
     }
-    // Based on the Timer State, update the RTOSTmrMatch using RTOSTmrTickCtr, RTOSTmrDelay and RTOSTmrPeriod
-    // You may use the Hash Table to Insert the Running Timer Obj
-    if(ptmr->RTOSTmrOpt == RTOS_TMR_ONE_SHOT)
-        ptmr->RTOSTmrMatch = RTOSTmrTickCtr + ptmr->RTOSTmrDelay;
+    // Based on the Timer State, update the RTOSTmrMatch using the current Tick, RTOSTmrDelay and RTOSTmrPeriod
+    // The Tick is read and the Timer linked under the lock, so the Timer Task cannot collect the Tick in between
+    pthread_mutex_lock(&hash_table_mutex);
+    // A Running Timer is restarted, so take it out of its current Hash Table slot first
+    if(ptmr->RTOSTmrState == RTOS_TMR_STATE_RUNNING)
+        unlink_hash_entry(ptmr);
+    now_tick = current_tick();
+
+    tmr_write_begin(ptmr);
+    if(ptmr->RTOSTmrAbs == RTOS_TRUE && ptmr->RTOSTmrState == RTOS_TMR_STATE_STOPPED)
+        // Absolute Deadline set by RTOSTmrCreateAbs(), already in RTOSTmrMatch
+        ptmr->RTOSTmrAbs = RTOS_FALSE;
+
+    else if(ptmr->RTOSTmrOpt == RTOS_TMR_ONE_SHOT)
+        ptmr->RTOSTmrMatch = now_tick + ptmr->RTOSTmrDelay;
 
     else if(ptmr->RTOSTmrOpt == RTOS_TMR_PERIODIC && ptmr->RTOSTmrState == RTOS_TMR_STATE_STOPPED)
-        ptmr->RTOSTmrMatch = RTOSTmrTickCtr + ptmr->RTOSTmrDelay;
+        ptmr->RTOSTmrMatch = now_tick + ptmr->RTOSTmrDelay;
 
     else if(ptmr->RTOSTmrOpt == RTOS_TMR_PERIODIC && ptmr->RTOSTmrState == RTOS_TMR_STATE_COMPLETED)
-        ptmr->RTOSTmrMatch = RTOSTmrTickCtr + ptmr->RTOSTmrPeriod;
+        ptmr->RTOSTmrMatch = now_tick + ptmr->RTOSTmrPeriod;
 
-    else if(ptmr->RTOSTmrOpt == RTOS_TMR_PERIODIC && ptmr->RTOSTmrState == RTOS_TMR_STATE_RUNNING) {
-        remove_hash_entry(ptmr);
-        ptmr->RTOSTmrMatch = RTOSTmrTickCtr + ptmr->RTOSTmrPeriod;
+    else if(ptmr->RTOSTmrOpt == RTOS_TMR_PERIODIC && ptmr->RTOSTmrState == RTOS_TMR_STATE_RUNNING)
+        ptmr->RTOSTmrMatch = now_tick + ptmr->RTOSTmrPeriod;
 
-    }
     else{
+        tmr_write_end(ptmr);
+        pthread_mutex_unlock(&hash_table_mutex);
         *perr = RTOS_ERR_TMR_INVALID;
         return RTOS_FALSE;
     }
 
     ptmr->RTOSTmrState = RTOS_TMR_STATE_RUNNING;
-    insert_hash_entry(ptmr);
+    tmr_write_end(ptmr);
+    arm_hash_entry(ptmr);
+    pthread_mutex_unlock(&hash_table_mutex);
     return RTOS_TRUE;
 }
 
@@ -276,11 +483,13 @@ INT8U RTOSTmrStop(RTOS_TMR *ptmr, INT8U opt, void *callback_arg, INT8U *perr)
     if(ptmr->RTOSTmrCallback == NULL){
         *perr = RTOS_ERR_TMR_NO_CALLBACK;
     }
-    // Remove the Timer from the Hash Table List
-    remove_hash_entry(ptmr);
-
-    // Change the State to Stopped
+    // Remove the Timer from the Hash Table List and change the State to Stopped
+    pthread_mutex_lock(&hash_table_mutex);
+    unlink_hash_entry(ptmr);
+    tmr_write_begin(ptmr);
     ptmr->RTOSTmrState = RTOS_TMR_STATE_STOPPED;
+    tmr_write_end(ptmr);
+    pthread_mutex_unlock(&hash_table_mutex);
     // Call the Callback function if required
     if(opt == RTOS_TMR_OPT_CALLBACK){
         ptmr->RTOSTmrCallback(ptmr->RTOSTmrCallbackArg);
@@ -291,6 +500,74 @@ INT8U RTOSTmrStop(RTOS_TMR *ptmr, INT8U opt, void *callback_arg, INT8U *perr)
     return RTOS_TRUE;
 }
 
+// Function to copy the Name, State, remaining Ticks and Period of every Timer in use
+// Runs without any lock, each entry is read consistently through the Timer Sequence Lock
+// Returns the number of Timers in use, only max_count of them are copied to info
+INT32U RTOSTmrSnapshot(RTOS_TMR_INFO *info, INT32U max_count, INT8U *perr)
+{
+    RTOS_TMR *ptmr;
+    RTOS_TMR_INFO entry;
+    INT32U seq;
+    INT32U match;
+    INT32U count = 0;
+    INT32U tick = __atomic_load_n(&RTOSTmrTickCtr, __ATOMIC_RELAXED);
+
+    for(INT32U i = 0; i < TmrPoolSize; i++){
+        ptmr = &TmrPool[i];
+
+        // Retry while a writer is updating the Timer
+        do {
+            seq = __atomic_load_n(&ptmr->RTOSTmrSeq, __ATOMIC_ACQUIRE);
+            if(seq & 1)
+                continue;
+            entry.ptmr = ptmr;
+            entry.name = ptmr->RTOSTmrName;
+            entry.state = ptmr->RTOSTmrState;
+            entry.option = ptmr->RTOSTmrOpt;
+            entry.prio = ptmr->RTOSTmrPrio;
+            entry.period = ptmr->RTOSTmrPeriod;
+            match = ptmr->RTOSTmrMatch;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        } while((seq & 1) || seq != __atomic_load_n(&ptmr->RTOSTmrSeq, __ATOMIC_RELAXED));
+
+        if(entry.state == RTOS_TMR_STATE_UNUSED)
+            continue;
+        if(entry.state == RTOS_TMR_STATE_RUNNING && (INT32)(match - tick) > 0)
+            entry.remain = match - tick;
+        else
+            entry.remain = 0;
+
+        if(info != NULL && count < max_count)
+            info[count] = entry;
+        count++;
+    }
+
+    *perr = (info != NULL && count > max_count) ? RTOS_ERR_SNAPSHOT_TRUNCATED : RTOS_ERR_NONE;
+    return count;
+}
+
+// Function to set the Per Tick Callback Budget of the Timer Task (0 = Unlimited)
+void RTOSTmrBudgetSet(INT32U max_count, INT32U max_ns)
+{
+    pthread_mutex_lock(&hash_table_mutex);
+    RTOSTmrBudgetCnt = max_count;
+    RTOSTmrBudgetNs = max_ns;
+    pthread_mutex_unlock(&hash_table_mutex);
+}
+
+// Function to get the Timer Task Statistics
+void RTOSTmrStatsGet(RTOS_TMR_STATS *stats)
+{
+    if(stats == NULL)
+        return;
+    pthread_mutex_lock(&hash_table_mutex);
+    *stats = RTOSTmrStats;
+    stats->overflow_depth = overflow_count;
+    stats->bucket_count = hash_size;
+    stats->armed_count = hash_timer_count;
+    pthread_mutex_unlock(&hash_table_mutex);
+}
+
 // Function called when OS Tick Interrupt Occurs which will signal the RTOSTmrTask() to update the Timers
 void RTOSTmrSignal(int signum)
 {
@@ -309,9 +586,14 @@ INT8U Create_Timer_Pool(INT32U timer_count)
 {
     // Create the Timer pool using Dynamic Memory Allocation
     // You can imagine of LinkedList Creation for Timer Obj
+    // All the Timers come from one array so RTOSTmrSnapshot() can walk them without the lists
+    TmrPool = (RTOS_TMR*)calloc(timer_count, sizeof(RTOS_TMR));
+    if(TmrPool == NULL && timer_count != 0)
+        return RTOS_MALLOC_ERR;
+    TmrPoolSize = timer_count;
 
     for(INT32U i = 0; i < timer_count; i++){
-        RTOS_TMR* new_timer = (RTOS_TMR*)malloc(sizeof(RTOS_TMR));
+        RTOS_TMR* new_timer = &TmrPool[i];
         new_timer->RTOSTmrState = RTOS_TMR_STATE_UNUSED;
         new_timer->RTOSTmrType = RTOS_TMR_TYPE;
         new_timer->RTOSTmrNext = FreeTmrListPtr;
@@ -326,123 +608,511 @@ INT8U Create_Timer_Pool(INT32U timer_count)
 }
 
 INT32U hashCode(RTOS_TMR* key) {
-    return (key->RTOSTmrMatch) % HASH_TABLE_SIZE;
+    return (key->RTOSTmrMatch) % hash_size;
 }
 
 // Initialize the Hash Table
 void init_hash_table(void)
 {
-    for(INT8 i = 0; i < HASH_TABLE_SIZE; i++){
-        hash_table[i].list_ptr = NULL;
-        hash_table[i].timer_count = 0;
+    hash_table = (HASH_OBJ*)calloc(HASH_TABLE_SIZE, sizeof(HASH_OBJ));
+    if(hash_table == NULL){
+        perror("Error: ");
+        exit(RTOS_MALLOC_ERR);
     }
+    hash_size = HASH_TABLE_SIZE;
+    hash_timer_count = 0;
+    old_hash_table = NULL;
+    old_hash_size = 0;
+    rehash_pos = 0;
+    for(INT8U prio = 0; prio < RTOS_TMR_PRIO_CLASSES; prio++){
+        overflow_queue[prio].list_ptr = NULL;
+        overflow_queue[prio].tail_ptr = NULL;
+        overflow_queue[prio].timer_count = 0;
+    }
+    overflow_count = 0;
 
 }
 
+// Link a Timer Object in its Hash Table bucket, hash_table_mutex must be held
+static void link_hash_entry(RTOS_TMR *timer_obj)
+{
+    // Calculate the index using Hash Function
+    HASH_OBJ *bucket = &hash_table[hashCode(timer_obj)];
+
+    // Add the Entry
+    timer_obj->RTOSTmrNext = bucket->list_ptr;
+    timer_obj->RTOSTmrPrev = NULL;
+
+    if(bucket->list_ptr != NULL)
+        bucket->list_ptr->RTOSTmrPrev = timer_obj;
+    bucket->list_ptr = timer_obj;
+    bucket->timer_count++;
+    timer_obj->RTOSTmrBucket = bucket;
+    __atomic_fetch_add(&hash_timer_count, 1, __ATOMIC_RELAXED);
+}
+
 // Insert a Timer Object in the Hash Table
 void insert_hash_entry(RTOS_TMR *timer_obj)
 {
-    // Calculate the index using Hash Function
-    INT32U index = hashCode(timer_obj);
     // Lock the Resources
     pthread_mutex_lock(&hash_table_mutex);
     // Add the Entry
-    timer_obj->RTOSTmrNext = hash_table[index].list_ptr;
+    link_hash_entry(timer_obj);
+    // Unlock the Resources
+    pthread_mutex_unlock(&hash_table_mutex);
+
+}
+
+// Unlink a Timer Object from the Overflow Queue of its Priority Class, hash_table_mutex must be held
+static void unlink_overflow_entry(RTOS_TMR *timer_obj)
+{
+    OVERFLOW_OBJ *queue = &overflow_queue[timer_obj->RTOSTmrPrio];
+
+    if (timer_obj->RTOSTmrPrev != NULL)
+        timer_obj->RTOSTmrPrev->RTOSTmrNext = timer_obj->RTOSTmrNext;
+    else
+        queue->list_ptr = timer_obj->RTOSTmrNext;
+    if (timer_obj->RTOSTmrNext != NULL)
+        timer_obj->RTOSTmrNext->RTOSTmrPrev = timer_obj->RTOSTmrPrev;
+    else
+        queue->tail_ptr = timer_obj->RTOSTmrPrev;
+
+    timer_obj->RTOSTmrNext = NULL;
     timer_obj->RTOSTmrPrev = NULL;
+    timer_obj->RTOSTmrDeferred = RTOS_FALSE;
+    queue->timer_count--;
+    overflow_count--;
+}
 
-    if(hash_table[index].list_ptr != NULL)
-        hash_table[index].list_ptr->RTOSTmrPrev = timer_obj;
-    hash_table[index].list_ptr = timer_obj;
-    hash_table[index].timer_count++;
+// Append an Expired Timer Object to the Overflow Queue of its Priority Class, hash_table_mutex must be held
+static void append_overflow_entry(RTOS_TMR *timer_obj)
+{
+    OVERFLOW_OBJ *queue = &overflow_queue[timer_obj->RTOSTmrPrio];
 
-    // Unlock the Resources
+    timer_obj->RTOSTmrNext = NULL;
+    timer_obj->RTOSTmrPrev = queue->tail_ptr;
+    if (queue->tail_ptr != NULL)
+        queue->tail_ptr->RTOSTmrNext = timer_obj;
+    else
+        queue->list_ptr = timer_obj;
+    queue->tail_ptr = timer_obj;
+    timer_obj->RTOSTmrDeferred = RTOS_TRUE;
+    timer_obj->RTOSTmrLate = RTOS_FALSE;
+    queue->timer_count++;
+    overflow_count++;
+    if (overflow_count > RTOSTmrStats.overflow_peak)
+        RTOSTmrStats.overflow_peak = overflow_count;
+
+#if RTOS_CFG_TMR_PRIO_THREAD
+    // Wake up the High Priority Dispatch Task
+    if (timer_obj->RTOSTmrPrio == RTOS_TMR_PRIO_HIGH)
+        sem_post(&prio_task_sem);
+#endif
+}
+
+// Take the next Expired Timer to dispatch, highest Priority Class first, hash_table_mutex must be held
+static RTOS_TMR* pop_overflow_entry(INT8U first_prio, INT8U last_prio)
+{
+    RTOS_TMR *timer_obj;
+
+    for (INT8U prio = first_prio; prio <= last_prio; prio++) {
+        timer_obj = overflow_queue[prio].list_ptr;
+        if (timer_obj != NULL) {
+            unlink_overflow_entry(timer_obj);
+            tmr_write_begin(timer_obj);
+            timer_obj->RTOSTmrState = RTOS_TMR_STATE_COMPLETED;
+            tmr_write_end(timer_obj);
+            return timer_obj;
+        }
+    }
+    return NULL;
+}
+
+// Number of Expired Timers waiting for the Timer Task, hash_table_mutex must be held
+static INT32U task_overflow_count(void)
+{
+    INT32U count = 0;
+
+    for (INT8U prio = TASK_FIRST_PRIO; prio < RTOS_TMR_PRIO_CLASSES; prio++)
+        count += overflow_queue[prio].timer_count;
+    return count;
+}
+
+// Count the Expiries the Timer Task leaves queued for the next Tick, each one only the first time
+// New Expiries are always appended, so the ones not counted yet are at the tail, the walk stops at the first counted one
+static void count_deferred(void)
+{
+    RTOS_TMR *temp;
+
+    for (INT8U prio = TASK_FIRST_PRIO; prio < RTOS_TMR_PRIO_CLASSES; prio++) {
+        for (temp = overflow_queue[prio].tail_ptr; temp != NULL && temp->RTOSTmrLate == RTOS_FALSE; temp = temp->RTOSTmrPrev) {
+            temp->RTOSTmrLate = RTOS_TRUE;
+            RTOSTmrStats.deferred_count++;
+        }
+    }
+}
+
+// Unlink a Timer Object from its Hash Table list, hash_table_mutex must be held
+static void unlink_hash_entry(RTOS_TMR *timer_obj)
+{
+    // The bucket may be in the old Hash Table while it is being resized
+    HASH_OBJ *bucket = timer_obj->RTOSTmrBucket;
+
+    // Expired Timers waiting for their Callback are in the Overflow Queue instead
+    if (timer_obj->RTOSTmrDeferred == RTOS_TRUE) {
+        unlink_overflow_entry(timer_obj);
+        return;
+    }
+    if (bucket == NULL)
+        return;
+
+    if (timer_obj->RTOSTmrPrev != NULL)
+        timer_obj->RTOSTmrPrev->RTOSTmrNext = timer_obj->RTOSTmrNext;
+    else
+        bucket->list_ptr = timer_obj->RTOSTmrNext;
+    if (timer_obj->RTOSTmrNext != NULL)
+        timer_obj->RTOSTmrNext->RTOSTmrPrev = timer_obj->RTOSTmrPrev;
+
+    timer_obj->RTOSTmrNext = NULL;
+    timer_obj->RTOSTmrPrev = NULL;
+    timer_obj->RTOSTmrBucket = NULL;
+    bucket->timer_count--;
+    __atomic_fetch_sub(&hash_timer_count, 1, __ATOMIC_RELAXED);
+}
+
+// Start growing or shrinking the Hash Table when the armed Timers cross the load thresholds
+// Called by the Timer Task only, the Timers are moved later by rehash_step()
+static void hash_resize_check(void)
+{
+    HASH_OBJ *new_table;
+    INT32U new_size;
+    INT32U armed;
+
+    // Only the Timer Task changes the Hash Table geometry, so it can read it without the lock
+    if (old_hash_table != NULL)
+        return;
+    // The API threads change the count meanwhile, a slightly stale value only moves the resize by a pass
+    armed = __atomic_load_n(&hash_timer_count, __ATOMIC_RELAXED);
+    if (armed > hash_size * RTOS_CFG_HASH_GROW_LOAD && hash_size < RTOS_CFG_HASH_MAX_SIZE)
+        new_size = (hash_size * 2 < RTOS_CFG_HASH_MAX_SIZE) ? hash_size * 2 : RTOS_CFG_HASH_MAX_SIZE;
+    else if (armed < hash_size * RTOS_CFG_HASH_SHRINK_LOAD && hash_size > HASH_TABLE_SIZE)
+        new_size = (hash_size / 2 > HASH_TABLE_SIZE) ? hash_size / 2 : HASH_TABLE_SIZE;
+    else
+        return;
+
+    // Allocate outside the lock, a failure just keeps the current size
+    new_table = (HASH_OBJ*)calloc(new_size, sizeof(HASH_OBJ));
+    if (new_table == NULL)
+        return;
+
+    // New Timers go to the new Hash Table from now on
+    pthread_mutex_lock(&hash_table_mutex);
+    old_hash_table = hash_table;
+    old_hash_size = hash_size;
+    rehash_pos = 0;
+    hash_table = new_table;
+    hash_size = new_size;
+    RTOSTmrStats.resizes++;
     pthread_mutex_unlock(&hash_table_mutex);
+}
 
+// Move the next slice of buckets of the old Hash Table, hash_table_mutex must be held
+static void rehash_step(void)
+{
+    RTOS_TMR *timer_obj;
+    INT32U step;
+
+    if (old_hash_table == NULL)
+        return;
+
+    // The whole resize is spread over RTOS_CFG_HASH_REHASH_TICKS Timer Task passes whatever the size
+    step = old_hash_size / RTOS_CFG_HASH_REHASH_TICKS + 1;
+    for (INT32U n = 0; n < step && rehash_pos < old_hash_size; n++, rehash_pos++) {
+        while ((timer_obj = old_hash_table[rehash_pos].list_ptr) != NULL) {
+            unlink_hash_entry(timer_obj);
+            link_hash_entry(timer_obj);
+        }
+    }
+
+    if (rehash_pos == old_hash_size) {
+        free(old_hash_table);
+        old_hash_table = NULL;
+        old_hash_size = 0;
+    }
+}
+
+// Link a Running Timer Object, or queue it right away if its Tick was already collected
+// hash_table_mutex must be held
+static void arm_hash_entry(RTOS_TMR *timer_obj)
+{
+    if ((INT32)(timer_obj->RTOSTmrMatch - RTOSTmrTickCtr) <= 0)
+        append_overflow_entry(timer_obj);
+    else
+        link_hash_entry(timer_obj);
 }
 
 // Remove the Timer Object entry from the Hash Table
 void remove_hash_entry(RTOS_TMR *timer_obj)
 {
-    // Calculate the index using Hash Function
-    INT32U index = hashCode(timer_obj);
+    if (timer_obj == NULL)
+        return;
     // Lock the Resources
     pthread_mutex_lock(&hash_table_mutex);
     // Remove the Timer Obj
-    if (hash_table[index].list_ptr == NULL || timer_obj == NULL)
+    unlink_hash_entry(timer_obj);
+    // Unlock the Resources
+    pthread_mutex_unlock(&hash_table_mutex);
+}
+
+// ns elapsed on CLOCK_MONOTONIC since OSTickInitialize()
+static long long monotonic_ns(void)
+{
+    struct timespec now;
+    long long elapsed_ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed_ns = (long long)(now.tv_sec - RTOSTmrTickEpoch.tv_sec) * 1000000000LL
+                 + (now.tv_nsec - RTOSTmrTickEpoch.tv_nsec);
+    if (elapsed_ns < 0)
+        return 0;
+    return elapsed_ns;
+}
+
+// Ticks elapsed on CLOCK_MONOTONIC since OSTickInitialize()
+INT32U get_monotonic_tick(void)
+{
+    return (INT32U)(monotonic_ns() / RTOSTmrTickRate);
+}
+
+// Tick new deadlines are relative to, hash_table_mutex must be held
+// RTOSTmrTickCtr lags behind the Monotonic Tick while the Timer Task is busy, the later of the two is used
+static INT32U current_tick(void)
+{
+    INT32U now_tick = get_monotonic_tick();
+
+    if ((INT32)(now_tick - RTOSTmrTickCtr) > 0)
+        return now_tick;
+    return RTOSTmrTickCtr;
+}
+
+// Convert an Absolute CLOCK_MONOTONIC time to the first Tick at or after it
+INT32U timespec_to_tick(const struct timespec *ts)
+{
+    long long elapsed_ns;
+
+    elapsed_ns = (long long)(ts->tv_sec - RTOSTmrTickEpoch.tv_sec) * 1000000000LL
+                 + (ts->tv_nsec - RTOSTmrTickEpoch.tv_nsec);
+    if (elapsed_ns <= 0)
+        return 0;
+    return (INT32U)((elapsed_ns + RTOSTmrTickRate - 1) / RTOSTmrTickRate);
+}
+
+// Re-arm a Periodic Timer one period after its previous deadline, so it never drifts
+static void reschedule_periodic(RTOS_TMR *ptmr)
+{
+    INT32U now_tick;
+    INT32U missed;
+
+    // The due check and the link happen in one section, the Timer Task cannot collect the Tick in between
+    pthread_mutex_lock(&hash_table_mutex);
+    // Another thread may have Started or Stopped the Timer since its Callback returned
+    if(ptmr->RTOSTmrState != RTOS_TMR_STATE_COMPLETED) {
+        pthread_mutex_unlock(&hash_table_mutex);
         return;
+    }
+    now_tick = current_tick();
+    tmr_write_begin(ptmr);
+    ptmr->RTOSTmrMatch += ptmr->RTOSTmrPeriod;
+
+    // With RTOS_TMR_PERIOD_SKIP, jump over the periods that are already over but keep the phase
+    // With RTOS_TMR_PERIOD_CATCHUP, the Timer Task fires them one by one while catching up
+    if(ptmr->RTOSTmrPolicy == RTOS_TMR_PERIOD_SKIP && (INT32)(ptmr->RTOSTmrMatch - now_tick) <= 0) {
+        missed = (now_tick - ptmr->RTOSTmrMatch) / ptmr->RTOSTmrPeriod + 1;
+        ptmr->RTOSTmrMatch += missed * ptmr->RTOSTmrPeriod;
+    }
+
+    ptmr->RTOSTmrState = RTOS_TMR_STATE_RUNNING;
+    tmr_write_end(ptmr);
 
-    if (hash_table[index].list_ptr == timer_obj) {
-        //if its the head
-        hash_table[index].list_ptr = timer_obj->RTOSTmrNext;
-        if(hash_table[index].list_ptr != NULL)
-            hash_table[index].list_ptr->RTOSTmrPrev = NULL;
-        //remove timer_obj
-        timer_obj->RTOSTmrNext = NULL;
-        timer_obj->RTOSTmrPrev = NULL;
-        hash_table[index].timer_count--;
-    }
-    else {
-        //if its not the head
-        RTOS_TMR *temp = hash_table[index].list_ptr->RTOSTmrNext;
-        while (temp != NULL) {
-            if (temp == timer_obj) {
-                temp->RTOSTmrPrev->RTOSTmrNext = temp->RTOSTmrNext;
-                if(temp->RTOSTmrNext)
-                    temp->RTOSTmrNext->RTOSTmrPrev = temp->RTOSTmrPrev;
-                //remove temp
-                temp->RTOSTmrNext = NULL;
-                temp->RTOSTmrPrev = NULL;
-                hash_table[index].timer_count--;
-            }
-
-            temp = temp->RTOSTmrNext;
+    // A deferred Timer catching up can land on a Tick already processed, it is due right away
+    arm_hash_entry(ptmr);
+    pthread_mutex_unlock(&hash_table_mutex);
+}
+
+// Move the Timers of a bucket whose deadline is the given Tick to the Overflow Queue, hash_table_mutex must be held
+static void collect_bucket(HASH_OBJ *bucket, INT32U tick)
+{
+    RTOS_TMR *task_timer;
+    RTOS_TMR *next_timer;
+
+    // Compare each obj of linked list for Timer Completion
+    task_timer = bucket->list_ptr;
+    while(task_timer != NULL){
+        next_timer = task_timer->RTOSTmrNext;
+        RTOSTmrStats.nodes_scanned++;
+        if(task_timer->RTOSTmrMatch == tick){
+            unlink_hash_entry(task_timer);
+            append_overflow_entry(task_timer);
         }
+        task_timer = next_timer;
     }
+}
 
+// Move all the Timers whose deadline is the given Tick to the Overflow Queue, hash_table_mutex must be held
+static void collect_tick(INT32U tick)
+{
+    INT32U old_index;
 
-    // Unlock the Resources
-    pthread_mutex_unlock(&hash_table_mutex);
+    // Check the whole List associated with the index of the Hash Table
+    collect_bucket(&hash_table[tick % hash_size], tick);
+
+    // While resizing, Timers of the buckets not moved yet are still in the old Hash Table
+    if(old_hash_table != NULL) {
+        old_index = tick % old_hash_size;
+        if(old_index >= rehash_pos)
+            collect_bucket(&old_hash_table[old_index], tick);
+    }
+    RTOSTmrStats.ticks_collected++;
+}
+
+// Call the Callback of an Expired Timer, then re-arm it if Periodic or Delete it if One Shot
+static void expire_timer(RTOS_TMR *task_timer)
+{
+    INT8U err;
+
+    if(task_timer->RTOSTmrCallback != NULL)
+        task_timer->RTOSTmrCallback(task_timer->RTOSTmrCallbackArg);
+
+    // The Callback may have Started, Stopped or Deleted its own Timer
+    if(task_timer->RTOSTmrState != RTOS_TMR_STATE_COMPLETED)
+        return;
+    if(task_timer->RTOSTmrOpt == RTOS_TMR_PERIODIC)
+        reschedule_periodic(task_timer);
+    else
+        RTOSTmrDel(task_timer, &err);
+}
+
+// Nanoseconds elapsed on CLOCK_MONOTONIC since start
+static INT32U elapsed_ns(const struct timespec *start)
+{
+    struct timespec now;
+    long long ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ns = (long long)(now.tv_sec - start->tv_sec) * 1000000000LL + (now.tv_nsec - start->tv_nsec);
+    return (ns > 0xFFFFFFFFLL) ? 0xFFFFFFFF : (INT32U)ns;
 }
 
 // Timer Task to Manage the Running Timers
 void *RTOSTmrTask(void* temp)
 {
-    INT8U *perr;
+    INT32U now_tick;
+    long long now_ns;
+    INT64U late_ns;
+    INT32U dispatched;
+    INT32U pass_ns;
+    INT32U budget_cnt;
+    INT32U budget_ns;
+    struct timespec pass_start;
+    struct timespec dispatch_start;
     RTOS_TMR *task_timer;
+
     while(1) {
         // Wait for the signal from RTOSTmrSignal()
         sem_wait(&timer_task_sem);
-        // Once got the signal, Increment the Timer Tick Counter
-        RTOSTmrTickCtr++;
-        // Check the whole List associated with the index of the Hash Table
-
-        // Compare each obj of linked list for Timer Completion
-        // If the Timer is completed, Call its Callback Function, Remove the entry from Hash table
-        // If the Timer is Periodic then again insert it in the hash table
-        // Change the State
-        INT32U index = RTOSTmrTickCtr % HASH_TABLE_SIZE;
-        task_timer = hash_table[index].list_ptr;
-        while(task_timer != NULL){
-            if(RTOSTmrRemainGet(task_timer,perr) == 0){
-                RTOSTmrStop(task_timer, RTOS_TMR_OPT_CALLBACK, NULL, perr);
-                task_timer->RTOSTmrState = RTOS_TMR_STATE_COMPLETED;
-                if(task_timer->RTOSTmrOpt == RTOS_TMR_PERIODIC)
-                    RTOSTmrStart(task_timer, perr);
-                if(task_timer->RTOSTmrOpt == RTOS_TMR_ONE_SHOT)
-                    RTOSTmrDel(task_timer, perr);
-            }
-            task_timer = task_timer->RTOSTmrNext;
+        clock_gettime(CLOCK_MONOTONIC, &pass_start);
+        dispatched = 0;
+
+        if(RTOSTmrTickHook != NULL)
+            RTOSTmrTickHook();
+
+        // Follow the number of armed Timers with the Hash Table size
+        hash_resize_check();
+
+        // Once got the signal, advance the Timer Tick Counter up to the Monotonic Tick
+        // A late or coalesced signal must not lose Ticks, so every Tick in between is collected
+        // Timers left over from earlier passes stay ahead in the Overflow Queue, keeping deadline order
+        now_ns = monotonic_ns();
+        now_tick = (INT32U)(now_ns / RTOSTmrTickRate);
+        pthread_mutex_lock(&hash_table_mutex);
+        budget_cnt = RTOSTmrBudgetCnt;
+        budget_ns = RTOSTmrBudgetNs;
+
+        // Lateness of the oldest Tick collected in this pass against its ideal CLOCK_MONOTONIC time
+        if((INT32)(now_tick - RTOSTmrTickCtr) > 0) {
+            late_ns = now_ns % RTOSTmrTickRate + (INT64U)(now_tick - RTOSTmrTickCtr - 1) * RTOSTmrTickRate;
+            if(late_ns > RTOSTmrStats.collect_late_max_ns)
+                RTOSTmrStats.collect_late_max_ns = late_ns;
+            RTOSTmrStats.collect_late_sum_ns += late_ns;
+            RTOSTmrStats.collect_passes++;
+        }
+        while((INT32)(now_tick - RTOSTmrTickCtr) > 0) {
+            RTOSTmrTickCtr++;
+            collect_tick(RTOSTmrTickCtr);
+        }
+
+        // A Hash Table resize moves a few buckets once per pass, a pass catching up many Ticks does not migrate more
+        rehash_step();
+
+        // Call the Callbacks highest Priority Class first, in deadline order within a class,
+        // until the Per Tick Budget is used up, the time budget only counts the Callbacks
+        clock_gettime(CLOCK_MONOTONIC, &dispatch_start);
+        while(1) {
+            if(budget_cnt != 0 && dispatched >= budget_cnt)
+                break;
+            if(budget_ns != 0 && dispatched != 0 && elapsed_ns(&dispatch_start) >= budget_ns)
+                break;
+
+            task_timer = pop_overflow_entry(TASK_FIRST_PRIO, RTOS_TMR_PRIO_CLASSES - 1);
+            if(task_timer == NULL)
+                break;
+            dispatched++;
+
+            // Callbacks run without holding the Hash Table so they can Start/Stop/Delete Timers
+            pthread_mutex_unlock(&hash_table_mutex);
+            expire_timer(task_timer);
+            pthread_mutex_lock(&hash_table_mutex);
+        }
+
+        // Whatever is still queued waits for the next Tick
+        if(task_overflow_count() != 0) {
+            RTOSTmrStats.budget_exhausted++;
+            count_deferred();
+        }
+        pass_ns = elapsed_ns(&pass_start);
+        if(pass_ns > RTOSTmrStats.max_pass_ns)
+            RTOSTmrStats.max_pass_ns = pass_ns;
+        pthread_mutex_unlock(&hash_table_mutex);
+    }
+
+}
+
+#if RTOS_CFG_TMR_PRIO_THREAD
+// High Priority Dispatch Task, calls the RTOS_TMR_PRIO_HIGH Callbacks as soon as their Tick is collected
+void *RTOSTmrPrioTask(void* temp)
+{
+    RTOS_TMR *task_timer;
+
+    while(1) {
+        // Wait for the Timer Task to queue a High Priority Expiry
+        sem_wait(&prio_task_sem);
+        pthread_mutex_lock(&hash_table_mutex);
+        while((task_timer = pop_overflow_entry(RTOS_TMR_PRIO_HIGH, RTOS_TMR_PRIO_HIGH)) != NULL) {
+            pthread_mutex_unlock(&hash_table_mutex);
+            expire_timer(task_timer);
+            pthread_mutex_lock(&hash_table_mutex);
         }
+        pthread_mutex_unlock(&hash_table_mutex);
     }
 
 }
+#endif
 
 // Timer Initialization Function
 void RTOSTmrInit(void)
 {
     INT32U timer_count = 0;
     INT8	retVal;
-    pthread_attr_t attr;
 
     fprintf(stdout,"\n\nPlease Enter the number of Timers required in the Pool for the OS ");
     scanf("%d", &timer_count);
@@ -477,10 +1147,29 @@ void RTOSTmrInit(void)
         perror("Error: ");
         exit(RTOS_ERR_MUTEX_INIT_FAILED);
     }
-    // Create any Thread if required for Timer Task
-    retVal = pthread_create(&thread, NULL, RTOSTmrTask, NULL);
-    if(retVal != 0)
+    // Create any Thread if required for Timer Task, it runs with the scheduling of the OS Tick
+    retVal = OSTickThreadCreate(&thread, RTOSTmrTask);
+    if(retVal != 0){
+        // pthread_create() returns the error instead of setting errno
+        errno = retVal;
         perror("pthread_create");
+        return;
+    }
+
+#if RTOS_CFG_TMR_PRIO_THREAD
+    // Create the High Priority Dispatch Task
+    retVal = sem_init(&prio_task_sem,0,0);
+    if(retVal == -1){
+        perror("Error: ");
+        exit(RTOS_ERR_TSK_SEM_INIT_FAILED);
+    }
+    retVal = OSTickThreadCreate(&prio_thread, RTOSTmrPrioTask);
+    if(retVal != 0){
+        errno = retVal;
+        perror("pthread_create");
+        return;
+    }
+#endif
 
 
     fprintf(stdout,"\nRTOS Initialization Done...\n");
@@ -514,13 +1203,17 @@ RTOS_TMR* alloc_timer_obj(void)
 // Free the allocated timer object and put it back into free pool
 void free_timer_obj(RTOS_TMR *ptmr)
 {
-    // Lock the Resources
-    pthread_mutex_lock(&timer_pool_mutex);
     // Clear the Timer Fields
+    pthread_mutex_lock(&hash_table_mutex);
+    tmr_write_begin(ptmr);
     ptmr -> RTOSTmrPeriod = 0;
     ptmr -> RTOSTmrDelay = 0;
     // Change the State
     ptmr -> RTOSTmrState = RTOS_TMR_STATE_UNUSED;
+    tmr_write_end(ptmr);
+    pthread_mutex_unlock(&hash_table_mutex);
+    // Lock the Resources
+    pthread_mutex_lock(&timer_pool_mutex);
     // Return the Timer to Free Timer Pool
     ptmr -> RTOSTmrNext = FreeTmrListPtr;
     if(FreeTmrListPtr != NULL)
@@ -530,25 +1223,3 @@ void free_timer_obj(RTOS_TMR *ptmr)
     // Unlock the Resources
     pthread_mutex_unlock(&timer_pool_mutex);
 }
-
-// Function to Setup the Timer of Linux which will provide the Clock Tick Interrupt to the Timer Manager Module
-void OSTickInitialize(void) {
-    timer_t timer_id;
-    struct itimerspec time_value;
-
-    // Setup the time of the OS Tick as 100 ms after 3 sec of Initial Delay
-    time_value.it_interval.tv_sec = 0;
-    time_value.it_interval.tv_nsec = RTOS_CFG_TMR_TASK_RATE;
-
-    time_value.it_value.tv_sec = 0;
-    time_value.it_value.tv_nsec = RTOS_CFG_TMR_TASK_RATE;
-
-    // Change the Action of SIGALRM to call a function RTOSTmrSignal()
-    signal(SIGALRM, &RTOSTmrSignal);
-
-    // Create the Timer Object
-    timer_create(CLOCK_REALTIME, NULL, &timer_id);
-
-    // Start the Timer
-    timer_settime(timer_id, 0, &time_value, NULL);
-}
@@ -0,0 +1,545 @@
+// Header Files
+#include "Include/TypeDefines.h"
+#include "Include/TimerMgrHeader.h"
+#include "Include/TimerAPI.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*****************************************************
+ * Global Variables
+ *****************************************************
+ */
+// Tick Counter, Tick Time and Monotonic Time of Tick 0 of the Timer Manager
+extern INT32U RTOSTmrTickCtr;
+extern INT32U RTOSTmrTickRate;
+extern struct timespec RTOSTmrTickEpoch;
+
+// Shared Memory Segment of the Timer Service, NULL in Client Processes
+SHM_SEGMENT *shm_segment = NULL;
+
+// Service side Timers of every Client Slot, only touched by the Timer Task
+SHM_TMR_CTX shm_timers[RTOS_CFG_SHM_MAX_CLIENTS][RTOS_CFG_SHM_TMRS_PER_CLIENT];
+
+// Name given to the Service side Timers
+static INT8 shm_timer_name[] = "ShmTimer";
+
+// Timer Task passes until the next check for dead Clients
+static INT32U shm_reap_countdown = 0;
+
+// Slots of each Client with a Notification waiting for room in the Notification Ring
+static INT16U shm_pending[RTOS_CFG_SHM_MAX_CLIENTS];
+
+/*****************************************************
+ * Ring Functions
+ *****************************************************
+ */
+
+// Write a Message to a Single Producer Single Consumer Ring, RTOS_FALSE if it is full
+static INT8U ring_push(SHM_RING *ring, const SHM_MSG *msg)
+{
+    INT32U head = ring->head;
+    INT32U tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    if(head - tail >= RTOS_CFG_SHM_RING_SIZE)
+        return RTOS_FALSE;
+    ring->msgs[head & (RTOS_CFG_SHM_RING_SIZE - 1)] = *msg;
+    // Publish the Message only after it is written
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return RTOS_TRUE;
+}
+
+// Read a Message from a Single Producer Single Consumer Ring, RTOS_FALSE if it is empty
+static INT8U ring_pop(SHM_RING *ring, SHM_MSG *msg)
+{
+    INT32U tail = ring->tail;
+    INT32U head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    if(head == tail)
+        return RTOS_FALSE;
+    *msg = ring->msgs[tail & (RTOS_CFG_SHM_RING_SIZE - 1)];
+    // Give the entry back to the Producer only after it is read
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return RTOS_TRUE;
+}
+
+/*****************************************************
+ * Timer Service Functions
+ *****************************************************
+ */
+
+// Send a Notification to a Client
+// The last one of a Slot (One Shot Expiry or FAILED) frees the Slot in the Client, so it is kept until the Ring has room
+static void shm_notify(SHM_TMR_CTX *ctx, const SHM_MSG *msg)
+{
+    SHM_CLIENT *client = &shm_segment->clients[ctx->client];
+
+    if(ring_push(&client->notify_ring, msg) == RTOS_TRUE){
+        sem_post(&client->notify_sem);
+        return;
+    }
+    if(msg->op == RTOS_SHM_OP_EXPIRED && msg->option == RTOS_TMR_PERIODIC){
+        // The next Expiry of the same Timer follows, the Client only misses this one
+        __atomic_fetch_add(&client->notify_dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    ctx->notify_msg = *msg;
+    ctx->notify_pending = RTOS_TRUE;
+    shm_pending[ctx->client]++;
+}
+
+// Retry the Notifications kept by shm_notify() while the Ring has room
+static void shm_notify_pending(INT16U client)
+{
+    SHM_CLIENT *pclient = &shm_segment->clients[client];
+    SHM_TMR_CTX *ctx;
+
+    for(INT16U slot = 0; slot < RTOS_CFG_SHM_TMRS_PER_CLIENT && shm_pending[client] != 0; slot++){
+        ctx = &shm_timers[client][slot];
+        if(ctx->notify_pending == RTOS_FALSE)
+            continue;
+        if(ring_push(&pclient->notify_ring, &ctx->notify_msg) == RTOS_FALSE)
+            return;
+        sem_post(&pclient->notify_sem);
+        ctx->notify_pending = RTOS_FALSE;
+        shm_pending[client]--;
+    }
+}
+
+// Callback of the Service side Timers, forwards the Expiry to the Client
+static void shm_expire(void *arg)
+{
+    SHM_TMR_CTX *ctx = (SHM_TMR_CTX *)arg;
+    SHM_MSG msg;
+
+    msg.op = RTOS_SHM_OP_EXPIRED;
+    msg.option = ctx->option;
+    msg.prio = 0;
+    msg.status = RTOS_ERR_NONE;
+    msg.slot = ctx->slot;
+    msg.gen = ctx->gen;
+    msg.match = RTOSTmrTickCtr;
+    msg.period = 0;
+    msg.cookie = ctx->cookie;
+    shm_notify(ctx, &msg);
+
+    // The Timer Task Deletes a One Shot Timer once its Callback returns
+    if(ctx->option == RTOS_TMR_ONE_SHOT)
+        ctx->ptmr = NULL;
+}
+
+// Cancel the Service side Timer of a Client Slot
+static void shm_cancel(INT16U client, INT16U slot)
+{
+    SHM_TMR_CTX *ctx = &shm_timers[client][slot];
+    INT8U err;
+
+    // The Client no longer waits for the last Notification of this Slot
+    if(ctx->notify_pending == RTOS_TRUE){
+        ctx->notify_pending = RTOS_FALSE;
+        shm_pending[client]--;
+    }
+    if(ctx->ptmr == NULL)
+        return;
+    RTOSTmrDel(ctx->ptmr, &err);
+    ctx->ptmr = NULL;
+}
+
+// Arm the Service side Timer of a Client Slot on the requested Tick
+static void shm_arm(INT16U client, const SHM_MSG *msg)
+{
+    SHM_TMR_CTX *ctx = &shm_timers[client][msg->slot];
+    SHM_MSG reply;
+    INT8U prio = msg->prio;
+    INT8U err;
+
+    shm_cancel(client, msg->slot);
+
+    ctx->client = client;
+    ctx->slot = msg->slot;
+    ctx->gen = msg->gen;
+    ctx->option = msg->option;
+    ctx->cookie = msg->cookie;
+
+#if RTOS_CFG_TMR_PRIO_THREAD
+    // Only the Timer Task may write the Notification Rings
+    if(prio == RTOS_TMR_PRIO_HIGH)
+        prio = RTOS_TMR_PRIO_NORMAL;
+#endif
+
+    // The Client gave an absolute Tick, the Timer is armed on it directly, a Tick already processed Expires on the next pass
+    ctx->ptmr = create_tick_timer(msg->match, msg->period, msg->option, prio, shm_expire, ctx, shm_timer_name, &err);
+    if(ctx->ptmr != NULL && RTOSTmrStart(ctx->ptmr, &err) == RTOS_TRUE)
+        return;
+
+    // Tell the Client its Slot is not armed
+    if(ctx->ptmr != NULL)
+        RTOSTmrDel(ctx->ptmr, &err);
+    ctx->ptmr = NULL;
+    reply = *msg;
+    reply.op = RTOS_SHM_OP_FAILED;
+    reply.status = err;
+    shm_notify(ctx, &reply);
+}
+
+// Cancel all the Timers of a Client and give its area back
+static void shm_release(INT16U client)
+{
+    for(INT16U slot = 0; slot < RTOS_CFG_SHM_TMRS_PER_CLIENT; slot++)
+        shm_cancel(client, slot);
+    __atomic_store_n(&shm_segment->clients[client].state, RTOS_SHM_CLIENT_FREE, __ATOMIC_RELEASE);
+}
+
+// Drain the Request Rings of all the Clients, called by the Timer Task through RTOSTmrTickHook
+void shm_service_poll(void)
+{
+    SHM_CLIENT *client;
+    SHM_MSG msg;
+    INT8U reap = RTOS_FALSE;
+
+    // A Client which exited without RTOSTmrShmDetach() would keep its Timers firing forever
+    if(shm_reap_countdown == 0){
+        shm_reap_countdown = RTOS_CFG_SHM_REAP_TICKS;
+        reap = RTOS_TRUE;
+    }
+    shm_reap_countdown--;
+
+    for(INT16U i = 0; i < RTOS_CFG_SHM_MAX_CLIENTS; i++){
+        client = &shm_segment->clients[i];
+        if(__atomic_load_n(&client->state, __ATOMIC_ACQUIRE) != RTOS_SHM_CLIENT_ATTACHED)
+            continue;
+        if(reap == RTOS_TRUE && kill((pid_t)client->pid, 0) == -1 && errno == ESRCH){
+            shm_release(i);
+            continue;
+        }
+        shm_notify_pending(i);
+
+        while(ring_pop(&client->req_ring, &msg) == RTOS_TRUE){
+            if(msg.op == RTOS_SHM_OP_DETACH){
+                shm_release(i);
+                break;
+            }
+            if(msg.slot >= RTOS_CFG_SHM_TMRS_PER_CLIENT)
+                continue;
+            if(msg.op == RTOS_SHM_OP_ARM)
+                shm_arm(i, &msg);
+            else if(msg.op == RTOS_SHM_OP_CANCEL)
+                shm_cancel(i, msg.slot);
+        }
+    }
+}
+
+// Function to make this process the Timer Service of a Shared Memory Segment
+// Must be called after OSTickInitialize() and RTOSTmrInit()
+INT8U RTOSTmrShmServiceStart(const char *name, INT8U *perr)
+{
+    SHM_SEGMENT *seg;
+    int fd;
+
+    if(name == NULL){
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return RTOS_FALSE;
+    }
+
+    // Create the Shared Memory Segment
+    fd = shm_open(name, O_CREAT | O_RDWR, RTOS_CFG_SHM_MODE);
+    if(fd == -1){
+        perror("shm_open");
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return RTOS_FALSE;
+    }
+    // A Segment left over from an earlier run keeps its old mode, and fails here if another user owns it
+    if(fchmod(fd, RTOS_CFG_SHM_MODE) == -1){
+        perror("fchmod");
+        close(fd);
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return RTOS_FALSE;
+    }
+    if(ftruncate(fd, sizeof(SHM_SEGMENT)) == -1){
+        perror("ftruncate");
+        close(fd);
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return RTOS_FALSE;
+    }
+    seg = mmap(NULL, sizeof(SHM_SEGMENT), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(seg == MAP_FAILED){
+        perror("mmap");
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return RTOS_FALSE;
+    }
+
+    // Initialize the Segment, Clients only attach once the magic is set
+    memset(seg, 0, sizeof(SHM_SEGMENT));
+    seg->tick_rate = RTOSTmrTickRate;
+    seg->tick_epoch = RTOSTmrTickEpoch;
+    __atomic_store_n(&seg->magic, RTOS_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    memset(shm_timers, 0, sizeof(shm_timers));
+    memset(shm_pending, 0, sizeof(shm_pending));
+    shm_segment = seg;
+    RTOSTmrTickHook = shm_service_poll;
+
+    *perr = RTOS_ERR_NONE;
+    return RTOS_TRUE;
+}
+
+/*****************************************************
+ * Client Functions
+ *****************************************************
+ */
+
+// Current Tick of the Timer Service, derived from its CLOCK_MONOTONIC epoch
+static INT32U shm_client_tick(SHM_SEGMENT *seg)
+{
+    struct timespec now;
+    long long elapsed_ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed_ns = (long long)(now.tv_sec - seg->tick_epoch.tv_sec) * 1000000000LL
+                 + (now.tv_nsec - seg->tick_epoch.tv_nsec);
+    if(elapsed_ns < 0)
+        return 0;
+    return (INT32U)(elapsed_ns / seg->tick_rate);
+}
+
+// Function to attach this process as a Client of the Timer Service
+RTOS_SHM_CLIENT* RTOSTmrShmAttach(const char *name, INT8U *perr)
+{
+    RTOS_SHM_CLIENT *pclient;
+    SHM_SEGMENT *seg;
+    SHM_CLIENT *client;
+    INT32U expected;
+    int fd;
+
+    if(name == NULL){
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return NULL;
+    }
+
+    // Map the Segment created by the Timer Service
+    fd = shm_open(name, O_RDWR, 0);
+    if(fd == -1){
+        perror("shm_open");
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return NULL;
+    }
+    seg = mmap(NULL, sizeof(SHM_SEGMENT), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(seg == MAP_FAILED){
+        perror("mmap");
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return NULL;
+    }
+    if(__atomic_load_n(&seg->magic, __ATOMIC_ACQUIRE) != RTOS_SHM_MAGIC){
+        munmap(seg, sizeof(SHM_SEGMENT));
+        *perr = RTOS_ERR_SHM_OPEN_FAILED;
+        return NULL;
+    }
+
+    pclient = (RTOS_SHM_CLIENT *)malloc(sizeof(RTOS_SHM_CLIENT));
+    if(pclient == NULL){
+        munmap(seg, sizeof(SHM_SEGMENT));
+        *perr = RTOS_MALLOC_ERR;
+        return NULL;
+    }
+
+    // Claim a free Client area
+    for(INT16U i = 0; i < RTOS_CFG_SHM_MAX_CLIENTS; i++){
+        client = &seg->clients[i];
+        expected = RTOS_SHM_CLIENT_FREE;
+        if(!__atomic_compare_exchange_n(&client->state, &expected, RTOS_SHM_CLIENT_CLAIMED,
+                                        0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            continue;
+
+        client->pid = (INT32U)getpid();
+        client->notify_dropped = 0;
+        client->req_ring.head = 0;
+        client->req_ring.tail = 0;
+        client->notify_ring.head = 0;
+        client->notify_ring.tail = 0;
+        sem_init(&client->notify_sem, 1, 0);
+
+        pclient->segment = seg;
+        pclient->client = client;
+        pthread_mutex_init(&pclient->lock, NULL);
+        pclient->free_count = RTOS_CFG_SHM_TMRS_PER_CLIENT;
+        for(INT16U slot = 0; slot < RTOS_CFG_SHM_TMRS_PER_CLIENT; slot++){
+            pclient->free_slots[slot] = RTOS_CFG_SHM_TMRS_PER_CLIENT - 1 - slot;
+            pclient->slot_gen[slot] = 0;
+            pclient->slot_armed[slot] = RTOS_FALSE;
+        }
+
+        // The Timer Service starts draining the Request Ring from now on
+        __atomic_store_n(&client->state, RTOS_SHM_CLIENT_ATTACHED, __ATOMIC_RELEASE);
+        *perr = RTOS_ERR_NONE;
+        return pclient;
+    }
+
+    free(pclient);
+    munmap(seg, sizeof(SHM_SEGMENT));
+    *perr = RTOS_ERR_SHM_NO_CLIENT;
+    return NULL;
+}
+
+// Function to detach this process from the Timer Service, all its Timers are Cancelled
+INT8U RTOSTmrShmDetach(RTOS_SHM_CLIENT *pclient, INT8U *perr)
+{
+    SHM_MSG msg;
+
+    if(pclient == NULL){
+        *perr = RTOS_ERR_TMR_INVALID;
+        return RTOS_FALSE;
+    }
+    memset(&msg, 0, sizeof(msg));
+    msg.op = RTOS_SHM_OP_DETACH;
+    pthread_mutex_lock(&pclient->lock);
+    if(ring_push(&pclient->client->req_ring, &msg) == RTOS_FALSE){
+        pthread_mutex_unlock(&pclient->lock);
+        *perr = RTOS_ERR_SHM_RING_FULL;
+        return RTOS_FALSE;
+    }
+    pthread_mutex_unlock(&pclient->lock);
+    pthread_mutex_destroy(&pclient->lock);
+    munmap(pclient->segment, sizeof(SHM_SEGMENT));
+    free(pclient);
+    *perr = RTOS_ERR_NONE;
+    return RTOS_TRUE;
+}
+
+// Function to arm a Timer in the Timer Service, returns the Slot identifying it
+INT16U RTOSTmrShmArm(RTOS_SHM_CLIENT *pclient, INT32U delay, INT32U period, INT8U option, INT8U prio, INT32U cookie, INT8U *perr)
+{
+    SHM_MSG msg;
+    INT16U slot;
+
+    // ERROR Checking, the rest is checked by RTOSTmrCreate() in the Timer Service
+    if(pclient == NULL){
+        *perr = RTOS_ERR_TMR_INVALID;
+        return 0;
+    }
+    // The Service compares Ticks as signed differences, a longer delay would look already due
+    if(delay < 1 || delay > RTOS_TMR_MAX_TICKS){
+        *perr = RTOS_ERR_TMR_INVALID_DLY;
+        return 0;
+    }
+    pthread_mutex_lock(&pclient->lock);
+    if(pclient->free_count == 0){
+        pthread_mutex_unlock(&pclient->lock);
+        *perr = RTOS_ERR_SHM_NO_SLOT;
+        return 0;
+    }
+
+    slot = pclient->free_slots[--pclient->free_count];
+    msg.op = RTOS_SHM_OP_ARM;
+    msg.option = option;
+    msg.prio = prio;
+    msg.status = RTOS_ERR_NONE;
+    msg.slot = slot;
+    msg.gen = ++pclient->slot_gen[slot];
+    msg.match = shm_client_tick(pclient->segment) + delay;
+    msg.period = period;
+    msg.cookie = cookie;
+    if(ring_push(&pclient->client->req_ring, &msg) == RTOS_FALSE){
+        pclient->free_slots[pclient->free_count++] = slot;
+        pthread_mutex_unlock(&pclient->lock);
+        *perr = RTOS_ERR_SHM_RING_FULL;
+        return 0;
+    }
+
+    pclient->slot_armed[slot] = RTOS_TRUE;
+    pthread_mutex_unlock(&pclient->lock);
+    *perr = RTOS_ERR_NONE;
+    return slot;
+}
+
+// Function to cancel a Timer armed with RTOSTmrShmArm()
+INT8U RTOSTmrShmCancel(RTOS_SHM_CLIENT *pclient, INT16U slot, INT8U *perr)
+{
+    SHM_MSG msg;
+
+    // ERROR Checking
+    if(pclient == NULL || slot >= RTOS_CFG_SHM_TMRS_PER_CLIENT){
+        *perr = RTOS_ERR_TMR_INVALID;
+        return RTOS_FALSE;
+    }
+    pthread_mutex_lock(&pclient->lock);
+    if(pclient->slot_armed[slot] == RTOS_FALSE){
+        pthread_mutex_unlock(&pclient->lock);
+        *perr = RTOS_ERR_TMR_INACTIVE;
+        return RTOS_FALSE;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    msg.op = RTOS_SHM_OP_CANCEL;
+    msg.slot = slot;
+    msg.gen = pclient->slot_gen[slot];
+    if(ring_push(&pclient->client->req_ring, &msg) == RTOS_FALSE){
+        pthread_mutex_unlock(&pclient->lock);
+        *perr = RTOS_ERR_SHM_RING_FULL;
+        return RTOS_FALSE;
+    }
+
+    // Expiries of this Slot still in the Notification Ring are dropped by RTOSTmrShmPoll()
+    pclient->slot_armed[slot] = RTOS_FALSE;
+    pclient->free_slots[pclient->free_count++] = slot;
+    pthread_mutex_unlock(&pclient->lock);
+    *perr = RTOS_ERR_NONE;
+    return RTOS_TRUE;
+}
+
+// Function to get the next Expiry of this Client, optionally waiting for one
+// *perr is RTOS_ERR_NONE for an Expiry, or the error of a Timer the Service could not Arm
+INT8U RTOSTmrShmPoll(RTOS_SHM_CLIENT *pclient, INT8U wait, INT16U *pslot, INT32U *pcookie, INT8U *perr)
+{
+    SHM_MSG msg;
+
+    if(pclient == NULL){
+        *perr = RTOS_ERR_TMR_INVALID;
+        return RTOS_FALSE;
+    }
+
+    while(1){
+        pthread_mutex_lock(&pclient->lock);
+        while(ring_pop(&pclient->client->notify_ring, &msg) == RTOS_TRUE){
+            // Drop Expiries of Cancelled or re-Armed Timers
+            if(msg.slot >= RTOS_CFG_SHM_TMRS_PER_CLIENT || pclient->slot_armed[msg.slot] == RTOS_FALSE
+               || pclient->slot_gen[msg.slot] != msg.gen)
+                continue;
+
+            if(msg.op == RTOS_SHM_OP_FAILED || msg.option == RTOS_TMR_ONE_SHOT){
+                pclient->slot_armed[msg.slot] = RTOS_FALSE;
+                pclient->free_slots[pclient->free_count++] = msg.slot;
+            }
+            pthread_mutex_unlock(&pclient->lock);
+            *pslot = msg.slot;
+            *pcookie = msg.cookie;
+            *perr = msg.status;
+            return RTOS_TRUE;
+        }
+        // The lock is not held while sleeping, other threads of the Client keep Arming and Cancelling
+        pthread_mutex_unlock(&pclient->lock);
+        if(wait == RTOS_FALSE){
+            *perr = RTOS_ERR_SHM_NO_EVENT;
+            return RTOS_FALSE;
+        }
+        // Sleep until the Timer Service posts a Notification
+        while(sem_wait(&pclient->client->notify_sem) == -1 && errno == EINTR);
+    }
+}
+
+// Function to get the number of Periodic Expiries this Client lost because its Notification Ring was full
+INT32U RTOSTmrShmDroppedGet(RTOS_SHM_CLIENT *pclient)
+{
+    if(pclient == NULL)
+        return 0;
+    return __atomic_load_n(&pclient->client->notify_dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,267 @@
+// Header Files
+#define _GNU_SOURCE
+#include "Include/TypeDefines.h"
+#include "Include/TimerMgrHeader.h"
+#include "Include/TimerAPI.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+/*****************************************************
+ * Global Variables
+ *****************************************************
+ */
+// Tick Time and Monotonic Time of Tick 0 of the Timer Manager
+extern INT32U RTOSTmrTickRate;
+extern struct timespec RTOSTmrTickEpoch;
+
+// Semaphore for Signaling the Timer Task
+extern sem_t timer_task_sem;
+
+// OS Tick Statistics, only written by the Tick Source
+RTOS_TICK_STATS RTOSTickStats;
+
+// Ticks elapsed since Tick 0 according to the Tick Source
+static INT64U tick_total = 0;
+
+// Linux Timer of the SIGALRM Tick Source
+static timer_t tick_timer_id;
+
+// timerfd and Thread of the timerfd Tick Source
+static int tick_fd = -1;
+static pthread_t tick_thread;
+
+// Configuration given to OSTickInitializeCfg(), its scheduling applies to every thread doing Tick work
+static RTOS_TICK_CFG tick_cfg = { NULL, 0, 0, -1 };
+
+// RTOS_TRUE once a Tick Source is running, the Tick is started only once per process
+static INT8U tick_started = RTOS_FALSE;
+
+/*****************************************************
+ * OS Tick Functions
+ *****************************************************
+ */
+
+// Function called by the Tick Source on every Tick, expirations > 1 when Ticks were merged
+// Only uses async-signal-safe calls so it can run from a signal handler
+void OSTickSignal(INT32U expirations)
+{
+    struct timespec now;
+    INT64 late_ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(expirations == 0)
+        expirations = 1;
+    tick_total += expirations;
+
+    // Lateness against the ideal time of the last Tick in this wakeup
+    late_ns = (INT64)(now.tv_sec - RTOSTmrTickEpoch.tv_sec) * 1000000000LL
+              + (now.tv_nsec - RTOSTmrTickEpoch.tv_nsec)
+              - (INT64)(tick_total * RTOSTmrTickRate);
+    if(late_ns < 0)
+        late_ns = 0;
+
+    if(RTOSTickStats.ticks == 0 || (INT64U)late_ns < RTOSTickStats.jitter_min_ns)
+        RTOSTickStats.jitter_min_ns = late_ns;
+    if((INT64U)late_ns > RTOSTickStats.jitter_max_ns)
+        RTOSTickStats.jitter_max_ns = late_ns;
+    RTOSTickStats.jitter_sum_ns += late_ns;
+    RTOSTickStats.missed += expirations - 1;
+    RTOSTickStats.ticks++;
+
+    // Send the Signal to Timer Task using the Semaphore
+    sem_post(&timer_task_sem);
+}
+
+// Function to get the OS Tick Statistics
+void OSTickStatsGet(RTOS_TICK_STATS *stats)
+{
+    if(stats != NULL)
+        *stats = RTOSTickStats;
+}
+
+// Signal Handler of the SIGALRM Tick Source
+static void sigalrm_tick(int signum)
+{
+    int overrun = timer_getoverrun(tick_timer_id);
+
+    OSTickSignal(1 + (overrun > 0 ? overrun : 0));
+}
+
+// SIGALRM Tick Source, a Linux Timer signals the process on every Tick
+static INT8U sigalrm_start(const RTOS_TICK_CFG *cfg, INT8U *perr)
+{
+    struct itimerspec time_value;
+
+    // Setup the time of the OS Tick
+    time_value.it_interval.tv_sec = cfg->rate_ns / 1000000000;
+    time_value.it_interval.tv_nsec = cfg->rate_ns % 1000000000;
+
+    time_value.it_value = time_value.it_interval;
+
+    // Change the Action of SIGALRM to call a function sigalrm_tick()
+    signal(SIGALRM, &sigalrm_tick);
+
+    // Create the Timer Object
+    if(timer_create(CLOCK_MONOTONIC, NULL, &tick_timer_id) == -1){
+        perror("timer_create");
+        *perr = RTOS_ERR_TICK_INIT_FAILED;
+        return RTOS_FALSE;
+    }
+
+    // Start the Timer
+    timer_settime(tick_timer_id, 0, &time_value, NULL);
+    *perr = RTOS_ERR_NONE;
+    return RTOS_TRUE;
+}
+
+// Tick Thread of the timerfd Tick Source
+static void *RTOSTickTask(void *temp)
+{
+    INT64U expirations;
+    ssize_t len;
+
+    while(1) {
+        // Sleep until the next Tick, the count includes Ticks missed meanwhile
+        len = read(tick_fd, &expirations, sizeof(expirations));
+        if(len != sizeof(expirations)){
+            if(len == -1 && errno == EINTR)
+                continue;
+            perror("timerfd read");
+            return NULL;
+        }
+        OSTickSignal((INT32U)expirations);
+    }
+}
+
+// Function to create a thread with the scheduling of the OS Tick, SCHED_FIFO and CPU pinning from the Tick configuration
+// Used for the Tick thread and the Timer Task threads, so the whole Tick path runs at the same priority
+int OSTickThreadCreate(pthread_t *thread, void *(*task)(void *))
+{
+    struct sched_param param;
+    pthread_attr_t attr;
+    cpu_set_t cpus;
+    int retVal;
+
+    pthread_attr_init(&attr);
+    if(tick_cfg.fifo_prio > 0){
+        param.sched_priority = tick_cfg.fifo_prio;
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+        pthread_attr_setschedparam(&attr, &param);
+    }
+    if(tick_cfg.cpu >= 0){
+        CPU_ZERO(&cpus);
+        CPU_SET(tick_cfg.cpu, &cpus);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    }
+    retVal = pthread_create(thread, &attr, task, NULL);
+    if(retVal == EPERM && tick_cfg.fifo_prio > 0){
+        // SCHED_FIFO needs CAP_SYS_NICE, keep going with normal scheduling
+        fprintf(stderr, "\nSCHED_FIFO not permitted, thread uses normal scheduling\n");
+        pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+        retVal = pthread_create(thread, &attr, task, NULL);
+    }
+    pthread_attr_destroy(&attr);
+    return retVal;
+}
+
+// timerfd Tick Source, a dedicated thread reads a CLOCK_MONOTONIC timerfd, no signals involved
+static INT8U timerfd_start(const RTOS_TICK_CFG *cfg, INT8U *perr)
+{
+    struct itimerspec time_value;
+    int retVal;
+
+    tick_fd = timerfd_create(CLOCK_MONOTONIC, 0);
+    if(tick_fd == -1){
+        perror("timerfd_create");
+        *perr = RTOS_ERR_TICK_INIT_FAILED;
+        return RTOS_FALSE;
+    }
+
+    // Create the Tick Thread with the requested scheduling
+    retVal = OSTickThreadCreate(&tick_thread, RTOSTickTask);
+    if(retVal != 0){
+        errno = retVal;
+        perror("pthread_create");
+        close(tick_fd);
+        tick_fd = -1;
+        *perr = RTOS_ERR_TICK_INIT_FAILED;
+        return RTOS_FALSE;
+    }
+
+    // First Tick one period after the epoch, then every period, on absolute times so it never drifts
+    time_value.it_interval.tv_sec = cfg->rate_ns / 1000000000;
+    time_value.it_interval.tv_nsec = cfg->rate_ns % 1000000000;
+    time_value.it_value.tv_sec = RTOSTmrTickEpoch.tv_sec + time_value.it_interval.tv_sec;
+    time_value.it_value.tv_nsec = RTOSTmrTickEpoch.tv_nsec + time_value.it_interval.tv_nsec;
+    if(time_value.it_value.tv_nsec >= 1000000000){
+        time_value.it_value.tv_sec++;
+        time_value.it_value.tv_nsec -= 1000000000;
+    }
+    timerfd_settime(tick_fd, TFD_TIMER_ABSTIME, &time_value, NULL);
+
+    *perr = RTOS_ERR_NONE;
+    return RTOS_TRUE;
+}
+
+// Available Tick Sources
+const RTOS_TICK_SOURCE RTOSTickSrcSigalrm = { "sigalrm", sigalrm_start };
+const RTOS_TICK_SOURCE RTOSTickSrcTimerfd = { "timerfd", timerfd_start };
+
+// Function to start the OS Tick from the given Tick Source and at the given rate
+// Can only succeed once, a second call would move the epoch and rate under the armed Timers
+INT8U OSTickInitializeCfg(const RTOS_TICK_CFG *cfg, INT8U *perr)
+{
+    // ERROR Checking
+    if(tick_started == RTOS_TRUE){
+        *perr = RTOS_ERR_TICK_ALREADY_INIT;
+        return RTOS_FALSE;
+    }
+    if(cfg == NULL || cfg->source == NULL || cfg->source->start == NULL){
+        *perr = RTOS_ERR_TICK_INIT_FAILED;
+        return RTOS_FALSE;
+    }
+    if(cfg->rate_ns < RTOS_CFG_TMR_MIN_TASK_RATE){
+        *perr = RTOS_ERR_TICK_INVALID_RATE;
+        return RTOS_FALSE;
+    }
+    // The Timer Task threads are pinned to this CPU later, they could not be created on a CPU that doesn't exist
+    if(cfg->cpu < -1 || cfg->cpu >= CPU_SETSIZE || cfg->cpu >= sysconf(_SC_NPROCESSORS_CONF)){
+        *perr = RTOS_ERR_TICK_INIT_FAILED;
+        return RTOS_FALSE;
+    }
+
+    // Ticks are counted from now on CLOCK_MONOTONIC, so wall clock changes don't move the Timers
+    RTOSTmrTickRate = cfg->rate_ns;
+    tick_cfg = *cfg;
+    memset(&RTOSTickStats, 0, sizeof(RTOSTickStats));
+    tick_total = 0;
+    clock_gettime(CLOCK_MONOTONIC, &RTOSTmrTickEpoch);
+
+    if(cfg->source->start(cfg, perr) == RTOS_FALSE)
+        return RTOS_FALSE;
+    tick_started = RTOS_TRUE;
+    return RTOS_TRUE;
+}
+
+// Function to Setup the Timer of Linux which will provide the Clock Tick Interrupt to the Timer Manager Module
+void OSTickInitialize(void) {
+    RTOS_TICK_CFG cfg;
+    INT8U err;
+
+    // Setup the time of the OS Tick as 100 ms from SIGALRM
+    cfg.source = &RTOSTickSrcSigalrm;
+    cfg.rate_ns = RTOS_CFG_TMR_TASK_RATE;
+    cfg.fifo_prio = 0;
+    cfg.cpu = -1;
+    OSTickInitializeCfg(&cfg, &err);
+}